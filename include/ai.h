@@ -0,0 +1,38 @@
+#ifndef AI_H
+#define AI_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "game.h"
+
+#define AI_MAX_THREADS 64
+#define AI_MAX_PLAYERS 16               // Facções consideradas na busca; as demais não agem
+#define AI_MAX_UNITS 8                  // Unidades de cada facção que recebem ações
+#define AI_MAX_ACTIONS 64               // Ações candidatas em um estado
+#define AI_MAX_DEPTH 32                 // Profundidade máxima da descida na árvore
+
+#define AI_DEFAULT_BUDGET_MS 20
+#define AI_DEFAULT_NODES 8192
+
+typedef struct ai_config_t {
+    int budget_ms;                      // Tempo de cada decisão, ou 0 para limitar só pelas iterações
+    int iterations;                     // Iterações de cada decisão (somando as threads), ou 0 para limitar só pelo tempo
+    int threads;                        // Árvores independentes, uma por thread, somadas na raiz
+    int rollout_depth;                  // Ações sorteadas após a árvore, ou 0 para quatro rodadas
+    int node_limit;                     // Estados guardados em cada árvore
+    uint64_t seed;                      // Semente das simulações
+} ai_config_t;
+
+typedef struct ai_stats_t {
+    int iterations;                     // Simulações realizadas
+    int nodes;                          // Estados guardados, somando as árvores
+    int transpositions;                 // Descidas que chegaram a um estado já guardado por outro caminho
+} ai_stats_t;
+
+void init_ai_config(ai_config_t *config);
+int choose_action(const game_t *game, const char *faction, const ai_config_t *config, command_t *command, ai_stats_t *stats);
+
+#endif // AI_H
@@ -1,17 +1,19 @@
-#ifndef ALLIANCE_H
-#define ALLIANCE_H
-
-#include <stdlib.h>
-#include <stdio.h>
-#include <string.h>
-
-typedef struct alliance_t {
-    char name[15];
-    struct alliance_t *next;
-} alliance_t;
-
-alliance_t *allocate_alliance(char name[15]);
-void insert_alliance(alliance_t **alliances, char name[15]);
-void free_alliances(alliance_t **alliances);
-
+#ifndef ALLIANCE_H
+#define ALLIANCE_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pool.h"
+
+typedef struct alliance_t {
+    char name[15];
+    struct alliance_t *next;
+} alliance_t;
+
+alliance_t *allocate_alliance(char name[15]);
+void insert_alliance(alliance_t **alliances, char name[15]);
+void free_alliances(alliance_t **alliances);
+
 #endif
\ No newline at end of file
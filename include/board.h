@@ -8,6 +8,7 @@
 #include "faction.h"
 #include "building.h"
 #include "unit.h"
+#include "log.h"
 
 typedef enum node_e{
     PLANICE = 0,
@@ -15,33 +16,47 @@ typedef enum node_e{
     MONTANHA = 2
 } node_e;
 
+#define CELL_MASK 0x3F   // Bits da máscara de ocupação de uma célula
+#define CELL_DIRTY 0x80  // Célula alterada desde o último quadro impresso
+
 typedef struct node_t{
     int line;
     int col;
-    unit_t *unit;
-    unit_t *unit1;
-    unit_t *unit2;
+    unit_t *units;      // Unidades da célula, encadeadas por `cell_prev`/`cell_next`
+    int unit_count;
     building_t *building;
     faction_t *faction;
-    struct node_t *next;
 } node_t;
 
 typedef struct board_t{
     int lines;
     int columns;
-    node_t *head;
+    node_t *cells;  // Vetor contíguo de lines * columns células, linha a linha
+    char *render;   // Buffer de impressão: borda superior, linha de células e separador
+
+    // Impressão incremental (ver `set_board_keyframes`)
+    int keyframe_interval;  // Quadros entre dois quadros-chave; 0 imprime sempre o tabuleiro completo
+    int frame;              // Número do próximo quadro impresso
+    unsigned char *shown;   // Símbolo exibido de cada célula, com o bit CELL_DIRTY se alterada
+    int *dirty;             // Índices das células alteradas desde o último quadro
+    int dirty_count;
 }board_t;
 
 board_t *create_board(int lines, int columns);
 node_t *allocate_node(int line, int col, unit_t* unit, building_t* building, faction_t* faction);
+node_t *get_node_board(board_t *board, int line, int col);
 void insert_node(board_t *board, int line, int col, unit_t *unit, building_t *building, faction_t *faction);
 faction_t *get_faction_board(board_t *board, int line, int col);
 building_t *get_building_board(board_t *board, int line, int col);
 unit_t *get_unit_board(board_t *board, int line, int col);
 unit_t *get_unit1_board(board_t *board, int line, int col);
 unit_t *get_unit2_board(board_t *board, int line, int col);
+int remove_unit_board(board_t *board, unit_t *unit);
+void move_unit(board_t *board, unit_t *unit, int line, int col);
 void remove_node(board_t *board_t, int row, int col);
+int set_board_keyframes(board_t *board, int interval);
+board_t *copy_board(const board_t *board);
 void free_board(board_t *board);
-void print_board(FILE *log, board_t *board);
+void print_board(log_t *log, board_t *board);
 
 #endif
\ No newline at end of file
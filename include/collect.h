@@ -0,0 +1,15 @@
+#ifndef COLLECT_H
+#define COLLECT_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "unit.h"
+#include "terrain.h"
+
+void collect_units(const unit_store_t *store, const int *handles, int count, const terrain_t *terrain,
+                   int *yields, int *totals, int faction_count);
+void collect_units_scalar(const unit_store_t *store, const int *handles, int count, const terrain_t *terrain,
+                          int *yields, int *totals, int faction_count);
+
+#endif
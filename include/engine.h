@@ -0,0 +1,58 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "game.h"
+#include "pool.h"
+#include "snapshot.h"
+#include "ai.h"
+
+typedef struct game_config_t {
+    int rows;                           // Dimensões do tabuleiro
+    int columns;
+    int num_factions;                   // Comandos `pos` iniciais que posicionam facções
+    uint64_t seed;                      // Semente do terreno e dos sorteios da partida
+    int threads;                        // Threads usadas na geração do terreno
+    const char *log_path;               // Arquivo de log, ou NULL para descartar o log
+    unsigned int log_categories;        // Categorias registradas (combinação de `log_category_e`)
+    int keyframe_interval;              // Quadros entre dois tabuleiros completos no log
+} game_config_t;
+
+typedef struct game_faction_info_t {
+    char name[COMMAND_NAME_LEN];
+    int id;
+    int resources;
+    int power;
+} game_faction_info_t;
+
+typedef struct game_unit_info_t {
+    char name[COMMAND_NAME_LEN];
+    int x;
+    int y;
+    int type;                           // unit_e
+    int faction_id;                     // `game_faction_info_t.id`, ou -1
+} game_unit_info_t;
+
+game_t *game_create(const game_config_t *config);
+game_t *game_load(const game_config_t *config, const char *path);
+int game_save(const game_t *game, const char *path);
+game_t *game_fork(const game_t *game, const char *log_path);
+int game_apply_command(game_t *game, const command_t *command);
+int game_step_batch(game_t *game, const command_t *commands, size_t count);
+int game_query_faction(const game_t *game, const char *name, game_faction_info_t *info);
+int game_query_factions(const game_t *game, game_faction_info_t *infos, int capacity);
+int game_query_unit(const game_t *game, const char *name, game_unit_info_t *info);
+int game_query_handle(const game_t *game, int handle, game_unit_info_t *info);
+int game_query_nearby(const game_t *game, int line, int col, int radius, int *handles, int capacity);
+int game_query_nearest_enemy(const game_t *game, const char *name);
+int game_query_winner(const game_t *game, game_faction_info_t *info);
+int game_choose_action(const game_t *game, const char *faction, const ai_config_t *config, command_t *command);
+int game_walk_units(game_t *game, const char *const *names, int count, int line, int col, int budget);
+void game_destroy(game_t *game);
+void release_pools(void);
+
+#endif // ENGINE_H
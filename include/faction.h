@@ -1,27 +1,30 @@
-#ifndef FACTION_H
-#define FACTION_H
-
-#include <stdlib.h>
-#include <stdio.h>
-#include <string.h>
-
-#include "unit.h"
-#include "building.h"
-#include "alliance.h"
-
-typedef struct faction_t {
-    char name[15];
-    int resources;
-    int power;
-    unit_t *units;
-    building_t *buildings;
-    alliance_t *alliance;
-    struct faction_t *next;
-} faction_t;
-
-faction_t *allocate_faction(char name[15], int resources, int power);
-void insert_faction(faction_t **factions, char name[15], int resources, int power);
-faction_t *get_faction(faction_t **factions, char name[2]);
-void free_factions(faction_t **factions);
-
+#ifndef FACTION_H
+#define FACTION_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pool.h"
+
+#include "unit.h"
+#include "building.h"
+#include "alliance.h"
+
+typedef struct faction_t {
+    char name[15];
+    int id;                     // Ordem de criação da facção, usada em `unit_store_t.faction_id`
+    int resources;
+    int power;
+    unit_t *units;
+    building_t *buildings;
+    alliance_t *alliance;
+    struct faction_t *next;
+} faction_t;
+
+faction_t *allocate_faction(char name[15], int resources, int power);
+void insert_faction(faction_t **factions, char name[15], int resources, int power);
+faction_t *get_faction(faction_t **factions, char name[2]);
+void free_factions(faction_t **factions);
+
 #endif
\ No newline at end of file
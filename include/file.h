@@ -11,38 +11,42 @@
 #include "unit.h"
 #include "building.h"
 #include "alliance.h"
+#include "pool.h"
+#include "parser.h"
+#include "script.h"
+#include "log.h"
+#include "terrain.h"
+#include "rng.h"
+#include "game.h"
+#include "profile.h"
+#include "snapshot.h"
+#include "ai.h"
 
 #include "handlers.h"
 
 // Constants
 #define MAX_PART_LEN 15
-#define MAX_ACTION_LEN 10
-#define MAX_FACTION_NAME_LEN 10
-#define MAX_PARAMS 6
 
 // Structures
-typedef struct history {
-    char attacking_faction[MAX_FACTION_NAME_LEN];
-    char defending_faction[MAX_FACTION_NAME_LEN];
-    int stolen_resources;
-} history_t;
+typedef struct options {
+    int keyframe_interval;  // Quadros entre dois tabuleiros completos no log; 0 imprime sempre o tabuleiro completo
+    int pool_stats;         // Se diferente de 0, imprime os contadores dos pools de memória ao final
+    unsigned int log_categories; // Categorias registradas no log (combinação de `log_category_e`)
+    int log_thread;         // Se diferente de 0, o log é escrito no arquivo por uma thread separada
+    int threads;            // Threads usadas na geração do mapa de terrenos e nas simulações
+    uint64_t seed;          // Semente do gerador de números aleatórios da partida
+    int simulations;        // Se maior que 0, executa esse número de simulações em vez de uma partida
+    const char *log_path;   // Arquivo onde o log da partida é escrito
+    int profile;            // Se diferente de 0, imprime as medições de tempo ao final (requer PROFILE)
+    profile_format_e profile_format; // Formato das medições de tempo
+    int checkpoint_turn;    // Se maior que 0, grava um snapshot da partida após esse número de comandos
+    const char *checkpoint_path; // Arquivo do snapshot gravado em `checkpoint_turn`
+    const char *restore_path; // Se não for NULL, a partida continua deste snapshot
+    int bot_rounds;         // Se maior que 0, após a entrada cada facção joga essas rodadas escolhidas pela IA
+    int bot_budget_ms;      // Tempo de cada decisão da IA
+} options_t;
 
 // Function Declarations
-int read_dimensions(FILE *file, int *rows, int *columns);
-int read_num_factions(FILE *file, int *num_factions);
-int read_part_action(FILE *file, char *part, char *action);
-int read_alliances(FILE *file, char *faction);
-int read_attack(FILE *file, char *param, int *params);
-int read_combat(FILE *file, char *enemy_name, int *self_value, int *enemy_value);
-int read_position_faction(FILE *file, int *params);
-int read_position_unit(FILE *file, int *params);
-int read_building(FILE *file, int *params);
-int read_move(FILE *file, int *params);
-int read_collect(FILE *file, int *params);
-int read_defend(FILE *file, int *params);
-int read_win(FILE *file, int* type_a, char name_b[15], int* type_b);
-int read_lose(FILE *file, int* type_a, char name_b[15], int* type_b);
-int read_earn(FILE *file, int* param);
-int read_all_file(FILE *file);
+int read_all_file(FILE *file, options_t *options);
 
 #endif // FILE_H
@@ -0,0 +1,55 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board.h"
+#include "faction.h"
+#include "unit.h"
+#include "building.h"
+#include "index.h"
+#include "terrain.h"
+#include "rng.h"
+#include "log.h"
+#include "parser.h"
+#include "spatial.h"
+#include "path.h"
+
+#define MAX_FACTION_NAME_LEN COMMAND_NAME_LEN     // Cabe qualquer nome lido de um comando
+
+typedef struct history {
+    char attacking_faction[MAX_FACTION_NAME_LEN];   // Facção que realizou o último ataque
+    char defending_faction[MAX_FACTION_NAME_LEN];   // Facção atacada
+    int stolen_resources;                           // Recursos roubados no ataque
+} history_t;
+
+typedef struct game_t {
+    board_t *board;
+    const terrain_t *terrain;           // Mapa de terrenos, não pertence à partida (pode ser compartilhado)
+    faction_t *factions;
+    building_t *buildings;
+    unit_t *units;
+    name_index_t faction_index;         // Índices por nome, mantidos junto com as listas
+    name_index_t unit_index;
+    unit_store_t unit_store;            // Cópia das unidades em arrays paralelos
+    spatial_t spatial;                  // Baldes de unidades por região do tabuleiro, por handle do `unit_store`
+    pathfinder_t pathfinder;            // Buffers de busca de caminhos, reaproveitados entre buscas
+    rng_t rng;                          // Todos os sorteios da partida
+    history_t history;                  // Último ataque, desfeito por `defende`
+    log_t *log;
+    int pending_factions;               // Comandos `pos` que ainda posicionam facções
+    int turns;                          // Comandos já aplicados
+    char last_part[COMMAND_NAME_LEN];   // Parte do último comando aplicado
+} game_t;
+
+int start_game(game_t *game, int rows, int columns, int num_factions, const rng_t *rng, const terrain_t *terrain, log_t *log);
+void apply_command(game_t *game, const command_t *command);
+int nearest_enemy(const game_t *game, int handle);
+int walk_units(game_t *game, const int *handles, int count, int line, int col, int budget);
+faction_t *find_winner(const game_t *game);
+faction_t *finish_game(game_t *game);
+void end_game(game_t *game);
+
+#endif
@@ -6,5 +6,6 @@
 #include <string.h>
 
 #include "file.h"
+#include "montecarlo.h"
 
 #endif // INCLUDE_H
\ No newline at end of file
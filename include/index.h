@@ -0,0 +1,26 @@
+#ifndef INDEX_H
+#define INDEX_H
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct index_entry_t {
+    const char *key;        // Nome guardado no próprio objeto indexado
+    unsigned int hash;
+    void *value;
+} index_entry_t;
+
+typedef struct name_index_t {
+    index_entry_t *entries;
+    size_t capacity;        // Sempre uma potência de 2 (ou 0 antes da primeira inserção)
+    size_t count;           // Entradas ocupadas
+    size_t tombstones;      // Entradas removidas que ainda interrompem as sondagens
+} name_index_t;
+
+void init_index(name_index_t *index);
+int insert_index(name_index_t *index, const char *name, void *value);
+void *get_index(const name_index_t *index, const char *name);
+void remove_index(name_index_t *index, const char *name);
+void free_index(name_index_t *index);
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE (1 << 20)       // Bytes acumulados antes de cada escrita no arquivo
+#endif
+
+typedef enum log_category_e {
+    LOG_EVENTS = 1 << 0,                // Mensagens das ações
+    LOG_BOARD = 1 << 1,                 // Impressões do tabuleiro
+    LOG_TURNS = 1 << 2,                 // Resumo de fim de turno
+    LOG_RESULT = 1 << 3,                // Vencedor da partida
+    LOG_ALL = LOG_EVENTS | LOG_BOARD | LOG_TURNS | LOG_RESULT
+} log_category_e;
+
+typedef struct log_t {
+    FILE *file;
+    unsigned int categories;            // Categorias registradas; as demais são descartadas
+    char *buffer;                       // Buffer sendo preenchido
+    size_t used;
+    size_t capacity;
+    int failed;                         // 1 se alguma escrita no arquivo falhou
+    size_t written;                     // Bytes entregues para escrita no arquivo até agora
+
+    // Escrita em segundo plano (apenas se `threaded` for 1)
+    int threaded;
+    int stop;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;               // Há um buffer pendente ou o log está sendo fechado
+    pthread_cond_t done;                // O buffer pendente já foi escrito
+    char *pending;                      // Buffer entregue à thread de escrita, ou NULL
+    size_t pending_used;
+    char *spare;                        // Buffer livre para a próxima troca
+} log_t;
+
+/**
+ * @brief Verifica se uma categoria está sendo registrada, para evitar montar mensagens descartadas.
+ */
+#define LOG_ENABLED(log, category) (((log)->categories & (category)) != 0)
+
+/**
+ * @brief Escreve uma string literal no log, com o tamanho calculado em tempo de compilação.
+ */
+#define LOG_FIXED(log, category, literal) write_log((log), (category), "" literal, sizeof(literal) - 1)
+
+int open_log(log_t *log, const char *path, unsigned int categories, int threaded);
+void write_log(log_t *log, unsigned int category, const char *data, size_t length);
+void print_log(log_t *log, unsigned int category, const char *format, ...);
+void flush_log(log_t *log);
+int close_log(log_t *log);
+int parse_log_categories(const char *list, unsigned int *categories);
+
+#endif
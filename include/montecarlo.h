@@ -0,0 +1,14 @@
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "file.h"
+
+#define MONTECARLO_MAX_THREADS 64
+
+int run_montecarlo(FILE *file, options_t *options);
+
+#endif // MONTECARLO_H
@@ -0,0 +1,70 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COMMAND_NAME_LEN 15
+#define COMMAND_MAX_PARAMS 6
+#define SOURCE_RING_SIZE (1 << 16)      // Buffer circular da leitura contínua; potência de 2
+
+typedef enum action_e {
+    ACTION_UNKNOWN = 0,
+    ACTION_ALLIANCE = 1,    // alianca
+    ACTION_ATTACK = 2,      // ataca
+    ACTION_COMBAT = 3,      // combate
+    ACTION_EARN = 4,        // ganha
+    ACTION_LOSE = 5,        // perde
+    ACTION_WIN = 6,         // vence
+    ACTION_POSITION = 7,    // pos
+    ACTION_MOVE = 8,        // move
+    ACTION_COLLECT = 9,     // coleta
+    ACTION_BUILD = 10,      // constroi
+    ACTION_DEFEND = 11,     // defende
+    ACTION_WALK = 12        // caminha
+} action_e;
+
+#define ACTION_LAST ACTION_WALK
+
+typedef struct command_t {
+    action_e action;
+    int param_count;                    // Inteiros lidos na linha
+    int params[COMMAND_MAX_PARAMS];
+    char part[COMMAND_NAME_LEN];        // Quem executa a ação (facção ou unidade)
+    char name[COMMAND_NAME_LEN];        // Primeiro parâmetro não numérico (facção ou unidade alvo)
+} command_t;
+
+typedef struct source_t {
+    const char *data;
+    size_t size;
+    size_t pos;
+    int mapped;                         // 1 se `data` foi mapeado com mmap, 0 se foi lido para a memória
+    int binary;                         // 1 se o conteúdo é um script compilado (veja script.h)
+    const char *names;                  // Tabela de nomes do script compilado
+    size_t name_count;
+
+    // Leitura contínua de um pipe ou FIFO (veja `open_stream`)
+    int streaming;                      // 1 se os comandos são lidos aos poucos para `ring`
+    int fd;
+    int eof;                            // 1 depois que o escritor fechou a entrada
+    int discard;                        // 1 enquanto descarta o resto de uma linha maior que o buffer
+    char *ring;                         // Buffer circular de SOURCE_RING_SIZE bytes
+    char *line;                         // Cópia contígua de uma linha que dá a volta no buffer
+    size_t head;                        // Contadores absolutos: primeiro byte ainda não consumido,
+    size_t scanned;                     // fim do trecho já procurado por '\n'
+    size_t tail;                        // e fim dos dados lidos
+    void (*on_wait)(void *context);     // Chamada antes de esperar por mais dados, se não for NULL
+    void *wait_context;
+} source_t;
+
+int open_source(source_t *source, FILE *file);
+int open_stream(source_t *source, FILE *file);
+void close_source(source_t *source);
+action_e parse_action(const char *word, size_t length);
+const char *get_action_name(action_e action);
+int read_header(source_t *source, int *rows, int *columns, int *num_factions);
+int read_command(source_t *source, command_t *command);
+int read_all_commands(source_t *source, command_t **commands, size_t *count);
+
+#endif
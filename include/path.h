@@ -0,0 +1,42 @@
+#ifndef PATH_H
+#define PATH_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "terrain.h"
+
+#define PATH_UNREACHABLE INT_MAX        // Custo de uma célula sem caminho
+#define PATH_NO_TARGET (-1)
+
+/*
+ * Buffers de busca de caminhos de uma partida, alocados na primeira busca e
+ * reaproveitados pelas seguintes. `cost`, `parent` e `stamp` valem para a última
+ * busca A*; `field` guarda o último campo de fluxo.
+ */
+typedef struct pathfinder_t {
+    int lines;
+    int columns;
+    int *cost;                          // Custo acumulado de cada célula na busca atual
+    int *parent;                        // Célula anterior no melhor caminho encontrado
+    unsigned int *stamp;                // Busca em que `cost` e `parent` foram escritos
+    unsigned int generation;            // Número da busca atual
+    int *heap_cell;                     // Fila de prioridade (heap binário) da busca
+    int *heap_key;
+    int heap_count;
+    int heap_capacity;
+    int *path;                          // Células do último caminho, da origem (exclusive) ao destino
+    int path_length;
+    int *field;                         // Custo até o alvo do campo de fluxo, por célula
+    int field_target;                   // Célula alvo do campo de fluxo, ou PATH_NO_TARGET
+} pathfinder_t;
+
+void init_pathfinder(pathfinder_t *pathfinder, int lines, int columns);
+int step_cost(const terrain_t *terrain, int line, int col);
+int find_path(pathfinder_t *pathfinder, const terrain_t *terrain, int from_line, int from_col, int to_line, int to_col);
+int build_flow_field(pathfinder_t *pathfinder, const terrain_t *terrain, int to_line, int to_col);
+int follow_flow_field(const pathfinder_t *pathfinder, const terrain_t *terrain, int *line, int *col, int budget, int *steps);
+void free_pathfinder(pathfinder_t *pathfinder);
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+
+typedef enum pool_e {
+    POOL_UNIT = 0,
+    POOL_FACTION = 1,
+    POOL_BUILDING = 2,
+    POOL_ALLIANCE = 3,
+    POOL_COUNT
+} pool_e;
+
+typedef struct pool_stats_t {
+    const char *name;
+    size_t object_size;     // Tamanho de cada objeto, já alinhado
+    size_t live;            // Objetos em uso
+    size_t capacity;        // Objetos que cabem nos blocos já alocados
+    size_t live_bytes;      // Bytes ocupados pelos objetos em uso
+    size_t reserved_bytes;  // Bytes reservados em blocos
+    size_t slabs;           // Blocos alocados
+} pool_stats_t;
+
+void *pool_alloc(pool_e pool, size_t size);
+void pool_free(pool_e pool, void *object);
+void pool_stats(pool_e pool, pool_stats_t *stats);
+void print_pool_stats(FILE *out);
+void release_pools(void);
+
+#endif
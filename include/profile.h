@@ -0,0 +1,76 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "parser.h"
+
+typedef enum profile_format_e {
+    PROFILE_TABLE,                      // Tabela alinhada, para leitura
+    PROFILE_JSON                        // Um objeto JSON, para outras ferramentas
+} profile_format_e;
+
+/*
+ * Medições registradas: uma por ação (indexadas por `action_e`), seguidas da
+ * impressão do tabuleiro e da escrita no log. Os tempos são inclusivos: o tempo de
+ * uma ação inclui as impressões do tabuleiro feitas por ela, que incluem as escritas no log.
+ */
+typedef enum profile_slot_e {
+    PROFILE_BOARD = ACTION_LAST + 1,    // `print_board`
+    PROFILE_LOG,                        // `write_log` e `print_log`
+    PROFILE_SLOT_COUNT
+} profile_slot_e;
+
+int parse_profile_format(const char *name, profile_format_e *format);
+
+#ifdef PROFILE
+
+/**
+ * @brief Lê o relógio monotônico em nanossegundos.
+ */
+static inline uint64_t profile_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+void record_profile(int slot, uint64_t elapsed);
+int pause_profile(int paused);
+void print_profile(FILE *out, profile_format_e format);
+void reset_profile(void);
+
+/**
+ * @brief Marca o início de um trecho medido, guardando o relógio na variável `start`.
+ */
+#define PROFILE_BEGIN(start) uint64_t start = profile_now()
+
+/**
+ * @brief Registra em `slot` o tempo decorrido desde `PROFILE_BEGIN(start)`.
+ */
+#define PROFILE_END(slot, start) record_profile((slot), profile_now() - (start))
+
+/**
+ * @brief Suspende as medições da thread atual, guardando o estado anterior na variável `saved`.
+ */
+#define PROFILE_PAUSE(saved) int saved = pause_profile(1)
+
+/**
+ * @brief Restaura o estado das medições guardado por `PROFILE_PAUSE(saved)`.
+ */
+#define PROFILE_RESUME(saved) pause_profile(saved)
+
+#else
+
+// Sem PROFILE, a medição não gera nenhum código
+#define PROFILE_BEGIN(start) ((void) 0)
+#define PROFILE_END(slot, start) ((void) 0)
+#define PROFILE_PAUSE(saved) ((void) 0)
+#define PROFILE_RESUME(saved) ((void) 0)
+#define print_profile(out, format) ((void) 0)
+#define reset_profile() ((void) 0)
+
+#endif // PROFILE
+
+#endif // PROFILE_H
@@ -0,0 +1,19 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+#define RNG_DEFAULT_SEED 1
+
+typedef struct rng_t {
+    uint64_t state[4];                  // Estado do xoshiro256**
+} rng_t;
+
+void seed_rng(rng_t *rng, uint64_t seed);
+void stream_rng(rng_t *rng, uint64_t seed, int simulation, int thread);
+uint64_t next_rng(rng_t *rng);
+int range_rng(rng_t *rng, int bound);
+void jump_rng(rng_t *rng);
+void long_jump_rng(rng_t *rng);
+
+#endif
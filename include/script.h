@@ -0,0 +1,50 @@
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "parser.h"
+#include "index.h"
+
+#define SCRIPT_MAGIC "CSGB"
+#define SCRIPT_MAGIC_LEN 4
+#define SCRIPT_VERSION 1
+#define SCRIPT_NAME_SIZE 16             // Cada nome ocupa 16 bytes na tabela, completados com '\0'
+#define SCRIPT_NO_NAME UINT32_MAX
+
+/*
+ * Layout do script compilado (inteiros na ordem de bytes da máquina que o compilou):
+ *
+ *   script_header_t
+ *   script_command_t x command_count
+ *   char[SCRIPT_NAME_SIZE] x name_count   (a partir de names_offset)
+ */
+typedef struct script_header_t {
+    char magic[SCRIPT_MAGIC_LEN];
+    uint32_t version;
+    int32_t rows;
+    int32_t columns;
+    int32_t num_factions;
+    uint32_t name_count;
+    uint64_t command_count;
+    uint64_t names_offset;
+} script_header_t;
+
+typedef struct script_command_t {
+    uint8_t action;                     // action_e
+    uint8_t param_count;
+    uint16_t reserved;
+    uint32_t part;                      // Índice do nome na tabela
+    uint32_t name;                      // Índice do nome na tabela, ou SCRIPT_NO_NAME
+    int32_t params[COMMAND_MAX_PARAMS];
+} script_command_t;
+
+int is_script(const char *data, size_t size);
+int compile_script(FILE *input, FILE *output);
+int read_script_header(source_t *source, int *rows, int *columns, int *num_factions);
+int read_script_command(source_t *source, command_t *command);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "game.h"
+
+#define SNAPSHOT_MAGIC "CSGS"
+#define SNAPSHOT_MAGIC_LEN 4
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_NONE (-1)              // Ponteiro nulo, gravado como índice
+
+/*
+ * Layout do snapshot (inteiros na ordem de bytes da máquina que o gravou), em um único
+ * bloco contíguo. Os ponteiros viram índices nas listas gravadas, na ordem das listas:
+ *
+ *   snapshot_header_t
+ *   snapshot_faction_t x faction_count
+ *   snapshot_alliance_t x alliance_count     (as alianças de cada facção, em sequência)
+ *   snapshot_building_t x building_count
+ *   snapshot_unit_t x unit_count
+ *   snapshot_cell_t x cell_count              (apenas as células ocupadas)
+ *   int32_t x cell_unit_count                 (unidades de cada célula, na ordem do encadeamento)
+ *   int32_t x free_count                      (handles livres do `unit_store_t`)
+ *   int32_t x spatial_count                   (handles do índice espacial, balde a balde)
+ *   uint8_t x shown_count                     (impressão incremental: símbolo exibido de cada célula)
+ *   int32_t x dirty_count                     (impressão incremental: células alteradas)
+ */
+typedef struct snapshot_header_t {
+    char magic[SNAPSHOT_MAGIC_LEN];
+    uint32_t version;
+    uint64_t rng[4];                    // Estado do gerador da partida
+    uint32_t terrain_hash;              // Confere que o snapshot é restaurado sobre o mesmo terreno
+    int32_t rows;
+    int32_t columns;
+    int32_t pending_factions;
+    int32_t turns;
+    int32_t faction_count;
+    int32_t alliance_count;
+    int32_t building_count;
+    int32_t unit_count;
+    int32_t cell_count;
+    int32_t cell_unit_count;
+    int32_t store_count;                // Handles já usados no `unit_store_t` (vivos ou livres)
+    int32_t free_count;
+    int32_t spatial_count;
+    int32_t keyframe_interval;
+    int32_t frame;
+    int32_t shown_count;
+    int32_t dirty_count;
+    history_t history;
+    char last_part[COMMAND_NAME_LEN];
+} snapshot_header_t;
+
+typedef struct snapshot_faction_t {
+    char name[COMMAND_NAME_LEN];
+    uint8_t indexed;                    // 1 se o índice de facções aponta para esta facção
+    int32_t id;
+    int32_t resources;
+    int32_t power;
+    int32_t alliance_count;
+} snapshot_faction_t;
+
+typedef struct snapshot_alliance_t {
+    char name[COMMAND_NAME_LEN + 1];
+} snapshot_alliance_t;
+
+typedef struct snapshot_building_t {
+    int32_t x;
+    int32_t y;
+    int32_t type;                       // building_e
+    char name[COMMAND_NAME_LEN + 1];
+} snapshot_building_t;
+
+typedef struct snapshot_unit_t {
+    int32_t x;
+    int32_t y;
+    int32_t type;                       // unit_e
+    int32_t handle;                     // Handle no `unit_store_t`, ou UNIT_NO_HANDLE
+    int32_t faction_id;                 // `unit_store_t.faction_id` do handle
+    char name[COMMAND_NAME_LEN];
+    uint8_t indexed;                    // 1 se o índice de unidades aponta para esta unidade
+} snapshot_unit_t;
+
+typedef struct snapshot_cell_t {
+    int32_t cell;                       // linha * colunas + coluna
+    int32_t faction;                    // Índice na lista de facções, ou SNAPSHOT_NONE
+    int32_t building;                   // Índice na lista de edifícios, ou SNAPSHOT_NONE
+    int32_t unit_count;                 // Unidades da célula, em `cell_units`
+} snapshot_cell_t;
+
+int snapshot_game(const game_t *game, void **data, size_t *size);
+int restore_game(game_t *game, const void *data, size_t size, const terrain_t *terrain, log_t *log);
+int fork_game(game_t *child, const game_t *parent, log_t *log);
+int save_game(const game_t *game, const char *path);
+int load_game(game_t *game, const char *path, const terrain_t *terrain, log_t *log);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "unit.h"
+
+#define SPATIAL_BUCKET_SHIFT 3          // Baldes de 8x8 células
+#define SPATIAL_BUCKET_SIZE (1 << SPATIAL_BUCKET_SHIFT)
+#define SPATIAL_NONE (-1)               // Unidade fora do tabuleiro (ou sem balde)
+
+typedef struct spatial_bucket_t {
+    int *handles;                       // Handles do `unit_store_t` das unidades no balde
+    int count;
+    int capacity;
+} spatial_bucket_t;
+
+/*
+ * Índice espacial das unidades: o tabuleiro é dividido em uma grade uniforme de baldes
+ * e cada balde guarda os handles das unidades que estão nas suas células. As posições
+ * exatas vêm do `unit_store_t`.
+ */
+typedef struct spatial_t {
+    int lines;
+    int columns;
+    int bucket_lines;
+    int bucket_columns;
+    spatial_bucket_t *buckets;          // bucket_lines * bucket_columns baldes, linha a linha
+    int *bucket_of;                     // Balde de cada handle, ou SPATIAL_NONE
+    int *slot_of;                       // Posição de cada handle dentro do seu balde
+    int handle_capacity;
+} spatial_t;
+
+int init_spatial(spatial_t *spatial, int lines, int columns);
+int insert_spatial(spatial_t *spatial, const unit_store_t *store, int handle);
+int move_spatial(spatial_t *spatial, int handle, int line, int col);
+void remove_spatial(spatial_t *spatial, int handle);
+int query_rect_spatial(const spatial_t *spatial, const unit_store_t *store, int line0, int col0, int line1, int col1,
+                       int *handles, int capacity);
+int query_radius_spatial(const spatial_t *spatial, const unit_store_t *store, int line, int col, int radius,
+                         int *handles, int capacity);
+int nearest_enemy_spatial(const spatial_t *spatial, const unit_store_t *store, int handle,
+                          const unsigned char *friendly, int friendly_count);
+int copy_spatial(spatial_t *copy, const spatial_t *spatial);
+void free_spatial(spatial_t *spatial);
+
+#endif
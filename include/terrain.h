@@ -0,0 +1,25 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "board.h"
+
+#define TERRAIN_NONE 3                  // Terreno fora do mapa: não rende recursos
+#define TERRAIN_PADDING 4               // Bytes extras ao final da grade, para leituras de 32 bits no último terreno
+#define TERRAIN_MAX_THREADS 64
+
+typedef struct terrain_t {
+    int lines;
+    int columns;
+    unsigned char *cells;               // node_e de cada célula, em `cells[linha * columns + coluna]`
+} terrain_t;
+
+terrain_t *create_terrain(int lines, int columns);
+void generate_terrain(terrain_t *terrain, uint64_t seed, int threads);
+int get_terrain(const terrain_t *terrain, int line, int col);
+void free_terrain(terrain_t *terrain);
+
+#endif
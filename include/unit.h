@@ -1,26 +1,61 @@
-#ifndef UNIT_H
-#define UNIT_H
-
-#include <stdlib.h>
-#include <string.h>
-
-typedef enum unit_e {
-    SOLDIER = 1,
-    EXPLORER = 2
-} unit_e;
-
-typedef struct unit_t {
-    int x;
-    int y;
-    char name[15];
-    unit_e type;
-    struct unit_t *next;
-} unit_t;
-
-unit_t *allocate_unit(int x, int y, char name[15], unit_e type);
-void insert_unit(unit_t **units, int x, int y, char name[15], unit_e type);
-unit_t *get_unit(unit_t **units, char name[15]);
-void remove_unit(unit_t **units, int x, int y);
-void free_units(unit_t **units);
-
+#ifndef UNIT_H
+#define UNIT_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "pool.h"
+
+typedef enum unit_e {
+    SOLDIER = 1,
+    EXPLORER = 2
+} unit_e;
+
+typedef struct unit_t {
+    int x;
+    int y;
+    char name[15];
+    unit_e type;
+    struct unit_t *next;
+    struct unit_t *cell_prev;   // Unidades na mesma célula do tabuleiro
+    struct unit_t *cell_next;
+    int handle;                 // Posição da unidade no `unit_store_t`, ou UNIT_NO_HANDLE
+} unit_t;
+
+#define UNIT_NO_HANDLE (-1)
+
+/*
+ * Cópia das unidades em estrutura de arrays, para varreduras lineares sobre todas elas.
+ * O handle de uma unidade é a sua posição nos arrays e não muda enquanto ela existir.
+ */
+typedef struct unit_store_t {
+    int *x;
+    int *y;
+    unsigned char *type;        // unit_e; tipos desconhecidos são guardados como 0
+    int *faction_id;            // `faction_t.id`, ou -1 se a facção não existir
+    unsigned char *alive;       // 0 nas posições livres
+    unit_t **units;             // Unidade dona de cada handle
+    int count;                  // Posições já usadas (vivas ou livres)
+    int capacity;
+    int live;
+    int *free_handles;          // Handles liberados, reaproveitados primeiro
+    int free_count;
+} unit_store_t;
+
+unit_t *allocate_unit(int x, int y, char name[15], unit_e type);
+void insert_unit(unit_t **units, int x, int y, char name[15], unit_e type);
+unit_t *get_unit(unit_t **units, char name[15]);
+void remove_unit(unit_t **units, int x, int y);
+void delete_unit(unit_t **units, unit_t *unit);
+void free_units(unit_t **units);
+
+void init_unit_store(unit_store_t *store);
+int reserve_unit_store(unit_store_t *store, int count);
+int copy_unit_store(unit_store_t *copy, const unit_store_t *store);
+int insert_unit_store(unit_store_t *store, unit_t *unit, int faction_id);
+void move_unit_store(unit_store_t *store, int handle, int x, int y);
+void remove_unit_store(unit_store_t *store, int handle);
+int list_units_store(const unit_store_t *store, int faction_id, int *handles);
+void free_unit_store(unit_store_t *store);
+
 #endif
\ No newline at end of file
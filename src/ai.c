@@ -0,0 +1,606 @@
+/**
+ * @file ai.c
+ * @brief Oponente automático: escolhe a próxima ação de uma facção por busca em árvore
+ *        de Monte Carlo (MCTS), usando a própria partida como simulador.
+ *
+ * Cada iteração copia a partida com `fork_game`, desce a árvore escolhendo as ações por
+ * UCB1, aplica-as com `apply_command` (os mesmos manipuladores da partida real), sorteia
+ * mais algumas ações de todas as facções e avalia o resultado pelo critério de
+ * `find_winner` (poder + recursos). As facções agem em rodízio, a partir da que decide.
+ *
+ * As ações candidatas de uma facção são, para cada uma das suas primeiras AI_MAX_UNITS
+ * unidades, `coleta`, `combate` contra o inimigo mais próximo e `move` para uma célula
+ * vizinha; e, para a facção, `constroi` (se tiver recursos), `ataca` contra cada outra
+ * facção e `defende` logo depois de ser atacada.
+ *
+ * Os nós da árvore são estados, identificados por um hash das facções e das unidades:
+ * dois caminhos que levam ao mesmo estado (por exemplo, as mesmas ações em outra ordem)
+ * compartilham o nó e as estatísticas das ações seguintes (tabela de transposição). Cada
+ * thread constrói a sua árvore, com os seus sorteios, e as visitas das ações da raiz são
+ * somadas no final (paralelização na raiz); a ação mais visitada é a escolhida.
+ */
+
+#include "ai.h"
+#include "snapshot.h"
+#include "profile.h"
+
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define AI_NO_NODE (-1)
+#define AI_EXPLORATION 1.0              // Peso da exploração no UCB1, com recompensas entre 0 e 1
+#define AI_REWARD_SCALE 100.0           // Vantagem (poder + recursos) que vale 0,75 de recompensa
+#define AI_BUILD_COST 10                // Custo de RESOURCE_BUILDING (veja `handle_building`)
+
+typedef enum ai_kind_e {
+    AI_COLLECT,
+    AI_COMBAT,
+    AI_MOVE,
+    AI_BUILD,
+    AI_ATTACK,
+    AI_DEFEND
+} ai_kind_e;
+
+// Deslocamentos de `move`: cima, baixo, esquerda, direita
+static const int ai_directions[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+/*
+ * Ação candidata, guardada de forma compacta e convertida em `command_t` só ao ser aplicada.
+ */
+typedef struct ai_move_t {
+    unsigned char kind;                 // ai_kind_e
+    unsigned char arg;                  // Direção de `move`, ou jogador alvo de `ataca`
+    int handle;                         // Unidade (`unit_store_t`) que age, ou UNIT_NO_HANDLE
+} ai_move_t;
+
+typedef struct ai_edge_t {
+    ai_move_t move;
+    int visits;
+    double reward;                      // Soma das recompensas do jogador que age no nó de origem
+} ai_edge_t;
+
+typedef struct ai_node_t {
+    uint64_t hash;
+    int mover;                          // Jogador que age neste estado
+    int visits;
+    int edge_count;                     // -1 enquanto as ações do estado não foram geradas
+    ai_edge_t *edges;
+} ai_node_t;
+
+typedef struct ai_player_t {
+    char name[COMMAND_NAME_LEN];
+    int id;
+} ai_player_t;
+
+/*
+ * Dados da busca, compartilhados (apenas para leitura, exceto os contadores) pelas threads.
+ */
+typedef struct ai_search_t {
+    const game_t *game;                 // Estado da raiz, que não muda durante a busca
+    ai_player_t players[AI_MAX_PLAYERS];// Em ordem de jogada; o primeiro é quem decide
+    int player_count;
+    int root_score;                     // Poder + recursos de quem decide, na raiz
+    ai_move_t root_moves[AI_MAX_ACTIONS];
+    int root_count;
+    uint64_t root_hash;
+    int rollout_depth;
+    int node_limit;
+    int iterations;                     // Limite de iterações, ou 0
+    uint64_t deadline;                  // Fim da busca (CLOCK_MONOTONIC, em ns), ou 0
+    log_t log;                          // Log vazio das simulações
+    atomic_int next;                    // Próxima iteração, quando há limite de iterações
+    atomic_int failed;                  // 1 se faltou memória em alguma thread
+} ai_search_t;
+
+/*
+ * Árvore de uma thread.
+ */
+typedef struct ai_worker_t {
+    ai_search_t *search;
+    int index;
+    rng_t rng;
+    ai_node_t *nodes;
+    int node_count;
+    int *table;                         // Índices em `nodes`, por hash, com sondagem linear
+    size_t table_mask;
+    int iterations;
+    int transpositions;
+} ai_worker_t;
+
+/**
+ * @brief Lê o relógio monotônico, em nanossegundos.
+ */
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+/**
+ * @brief Acrescenta um valor ao hash de um estado.
+ */
+static inline uint64_t mix_hash(uint64_t hash, uint64_t value) {
+    hash = (hash ^ value) * 0x9E3779B97F4A7C15ull;
+    return hash ^ (hash >> 29);
+}
+
+/**
+ * @brief Indica se `defende` desfaz algo: a facção foi a vítima do último comando aplicado.
+ */
+static int can_defend(const game_t *game, const char *name) {
+    const history_t *history = &game->history;
+    return history->stolen_resources > 0 && strcmp(history->defending_faction, name) == 0 &&
+           strcmp(history->attacking_faction, game->last_part) == 0;
+}
+
+/**
+ * @brief Calcula o hash de um estado: recursos e poder dos jogadores, posição de cada
+ *        unidade viva e quem age. Os edifícios não entram: não mudam as ações nem a avaliação.
+ */
+static uint64_t hash_state(const game_t *game, const ai_search_t *search, int mover) {
+    uint64_t hash = mix_hash(0xCBF29CE484222325ull, (uint64_t) mover);
+    for (int i = 0; i < search->player_count; i++) {
+        const faction_t *faction = get_index(&game->faction_index, search->players[i].name);
+        if (faction == NULL) continue;
+        hash = mix_hash(hash, ((uint64_t) (uint32_t) faction->resources << 32) | (uint32_t) faction->power);
+    }
+
+    const unit_store_t *store = &game->unit_store;
+    for (int handle = 0; handle < store->count; handle++) {
+        if (!store->alive[handle]) continue;
+        hash = mix_hash(hash, ((uint64_t) handle << 40) ^ ((uint64_t) (uint32_t) store->x[handle] << 20) ^ (uint32_t) store->y[handle]);
+    }
+    return mix_hash(hash, (uint64_t) can_defend(game, search->players[mover].name));
+}
+
+/**
+ * @brief Lista as ações candidatas de um jogador no estado atual.
+ *
+ * @return A quantidade de ações, no máximo AI_MAX_ACTIONS.
+ */
+static int list_moves(const game_t *game, const ai_search_t *search, int player, ai_move_t *moves) {
+    const ai_player_t *self = &search->players[player];
+    const faction_t *faction = get_index(&game->faction_index, self->name);
+    if (faction == NULL) return 0;
+
+    const unit_store_t *store = &game->unit_store;
+    const board_t *board = game->board;
+    int count = 0, units = 0, first = UNIT_NO_HANDLE;
+    for (int handle = 0; handle < store->count && units < AI_MAX_UNITS; handle++) {
+        if (!store->alive[handle] || store->faction_id[handle] != self->id) continue;
+        if (units++ == 0) first = handle;
+
+        moves[count++] = (ai_move_t) {AI_COLLECT, 0, handle};
+        if (search->player_count > 1) moves[count++] = (ai_move_t) {AI_COMBAT, 0, handle};
+        for (int direction = 0; direction < 4; direction++) {
+            int line = store->x[handle] + ai_directions[direction][0];
+            int col = store->y[handle] + ai_directions[direction][1];
+            if (line < 0 || line >= board->lines || col < 0 || col >= board->columns) continue;
+            moves[count++] = (ai_move_t) {AI_MOVE, (unsigned char) direction, handle};
+        }
+    }
+
+    // AI_MAX_UNITS unidades usam no máximo 48 ações; as demais ficam com as da facção
+    if (first != UNIT_NO_HANDLE && faction->resources >= AI_BUILD_COST) {
+        moves[count++] = (ai_move_t) {AI_BUILD, 0, first};
+    }
+    if (can_defend(game, self->name) && count < AI_MAX_ACTIONS) {
+        moves[count++] = (ai_move_t) {AI_DEFEND, 0, UNIT_NO_HANDLE};
+    }
+    // `ataca` guarda os dois nomes no histórico da partida; nomes que não cabem nele não atacam
+    int fits = strnlen(self->name, COMMAND_NAME_LEN) < MAX_FACTION_NAME_LEN;
+    for (int other = 0; fits && other < search->player_count && count < AI_MAX_ACTIONS; other++) {
+        if (other == player || strnlen(search->players[other].name, COMMAND_NAME_LEN) >= MAX_FACTION_NAME_LEN) continue;
+        moves[count++] = (ai_move_t) {AI_ATTACK, (unsigned char) other, UNIT_NO_HANDLE};
+    }
+    return count;
+}
+
+/**
+ * @brief Converte uma ação candidata no comando correspondente.
+ *
+ * Uma ação de unidade cuja unidade não existe mais vira um comando de ação desconhecida,
+ * que não altera a partida.
+ */
+static void make_command(const game_t *game, const ai_search_t *search, int player, ai_move_t move, command_t *command) {
+    const unit_store_t *store = &game->unit_store;
+    memset(command, 0, sizeof(command_t));
+
+    const unit_t *unit = NULL;
+    if (move.handle != UNIT_NO_HANDLE) {
+        if (move.handle >= store->count || !store->alive[move.handle]) return;
+        unit = store->units[move.handle];
+        memcpy(command->part, unit->name, COMMAND_NAME_LEN);
+    } else {
+        memcpy(command->part, search->players[player].name, COMMAND_NAME_LEN);
+    }
+
+    switch ((ai_kind_e) move.kind) {
+        case AI_COLLECT:
+            command->action = ACTION_COLLECT;
+            command->param_count = 2;
+            command->params[0] = unit->type;
+            command->params[1] = 10;
+            break;
+        case AI_COMBAT:
+            // Sem nome, a unidade ataca o inimigo mais próximo
+            command->action = ACTION_COMBAT;
+            command->param_count = 2;
+            command->params[0] = unit->type;
+            command->params[1] = unit->type;
+            break;
+        case AI_MOVE:
+            command->action = ACTION_MOVE;
+            command->param_count = 3;
+            command->params[0] = unit->type;
+            command->params[1] = unit->x + ai_directions[move.arg][0];
+            command->params[2] = unit->y + ai_directions[move.arg][1];
+            break;
+        case AI_BUILD:
+            command->action = ACTION_BUILD;
+            memcpy(command->part, search->players[player].name, COMMAND_NAME_LEN);
+            command->param_count = 4;
+            command->params[0] = RESOURCE_BUILDING;
+            command->params[1] = 1;
+            command->params[2] = unit->x;
+            command->params[3] = unit->y;
+            break;
+        case AI_ATTACK:
+            command->action = ACTION_ATTACK;
+            memcpy(command->name, search->players[move.arg].name, COMMAND_NAME_LEN);
+            break;
+        case AI_DEFEND:
+            command->action = ACTION_DEFEND;
+            command->param_count = 2;
+            command->params[0] = 1;
+            command->params[1] = 1;
+            break;
+    }
+}
+
+/**
+ * @brief Aplica uma ação candidata à partida simulada.
+ */
+static void apply_move(game_t *game, const ai_search_t *search, int player, ai_move_t move) {
+    command_t command;
+    make_command(game, search, player, move, &command);
+    apply_command(game, &command);
+}
+
+/**
+ * @brief Avalia o estado para cada jogador, entre 0 e 1, pela vantagem de poder + recursos
+ *        sobre o melhor adversário (ou, sem adversários, sobre o próprio valor na raiz).
+ */
+static void score_players(const game_t *game, const ai_search_t *search, double *rewards) {
+    int scores[AI_MAX_PLAYERS];
+    for (int i = 0; i < search->player_count; i++) {
+        const faction_t *faction = get_index(&game->faction_index, search->players[i].name);
+        scores[i] = faction != NULL ? faction->power + faction->resources : 0;
+    }
+
+    for (int i = 0; i < search->player_count; i++) {
+        int best = search->player_count > 1 ? INT32_MIN : search->root_score;
+        for (int j = 0; j < search->player_count; j++) {
+            if (j != i && scores[j] > best) best = scores[j];
+        }
+        double advantage = (double) scores[i] - (double) best;
+        rewards[i] = 0.5 + 0.5 * advantage / (fabs(advantage) + AI_REWARD_SCALE);
+    }
+}
+
+/**
+ * @brief Procura um estado na árvore da thread, criando o nó se ainda não existir.
+ *
+ * @param created Recebe 1 se o nó foi criado agora.
+ * @return O nó, ou NULL se o estado é novo e a árvore já está no limite de nós.
+ */
+static ai_node_t *find_node(ai_worker_t *worker, uint64_t hash, int mover, int *created) {
+    *created = 0;
+    // A tabela tem pelo menos o dobro de posições que o limite de nós: sempre há uma vazia
+    size_t slot = (size_t) hash & worker->table_mask;
+    while (worker->table[slot] != AI_NO_NODE) {
+        ai_node_t *node = &worker->nodes[worker->table[slot]];
+        if (node->hash == hash && node->mover == mover) return node;
+        slot = (slot + 1) & worker->table_mask;
+    }
+    if (worker->node_count == worker->search->node_limit) return NULL;
+
+    ai_node_t *node = &worker->nodes[worker->node_count];
+    node->hash = hash;
+    node->mover = mover;
+    node->visits = 0;
+    node->edge_count = -1;
+    node->edges = NULL;
+    worker->table[slot] = worker->node_count++;
+    *created = 1;
+    return node;
+}
+
+/**
+ * @brief Gera as ações de um nó a partir do estado simulado.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a memória não puder ser alocada.
+ */
+static int expand_node(ai_node_t *node, const game_t *game, const ai_search_t *search, const ai_move_t *known, int known_count) {
+    ai_move_t moves[AI_MAX_ACTIONS];
+    int count = known != NULL ? known_count : list_moves(game, search, node->mover, moves);
+    if (known == NULL) known = moves;
+
+    node->edges = count > 0 ? (ai_edge_t *) malloc((size_t) count * sizeof(ai_edge_t)) : NULL;
+    if (count > 0 && node->edges == NULL) return 1;
+    for (int i = 0; i < count; i++) {
+        node->edges[i].move = known[i];
+        node->edges[i].visits = 0;
+        node->edges[i].reward = 0.0;
+    }
+    node->edge_count = count;
+    return 0;
+}
+
+/**
+ * @brief Escolhe a ação a seguir em um nó: uma ainda não visitada, se houver (a partir
+ *        de uma posição sorteada), ou a de maior UCB1.
+ */
+static int select_edge(ai_worker_t *worker, const ai_node_t *node) {
+    int start = range_rng(&worker->rng, node->edge_count);
+    for (int i = 0; i < node->edge_count; i++) {
+        int edge = (start + i) % node->edge_count;
+        if (node->edges[edge].visits == 0) return edge;
+    }
+
+    double exploration = AI_EXPLORATION * sqrt(log((double) node->visits));
+    int best = 0;
+    double best_value = -1.0;
+    for (int edge = 0; edge < node->edge_count; edge++) {
+        const ai_edge_t *candidate = &node->edges[edge];
+        double value = candidate->reward / candidate->visits + exploration / sqrt((double) candidate->visits);
+        if (value > best_value) {
+            best_value = value;
+            best = edge;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Executa uma iteração: descida na árvore, sorteio das ações seguintes, avaliação
+ *        e atualização das estatísticas do caminho.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a memória não puder ser alocada.
+ */
+static int run_iteration(ai_worker_t *worker) {
+    ai_search_t *search = worker->search;
+    game_t game;
+    if (fork_game(&game, search->game, &search->log) != 0) return 1;
+    // Cada simulação tem os seus próprios sorteios (combates e ataques)
+    for (int i = 0; i < 4; i++) game.rng.state[i] = next_rng(&worker->rng);
+
+    ai_node_t *path[AI_MAX_DEPTH];
+    int edges[AI_MAX_DEPTH];
+    int depth = 0, mover = 0;
+    ai_node_t *node = &worker->nodes[0];
+    while (node != NULL && depth < AI_MAX_DEPTH) {
+        if (node->edge_count < 0 && expand_node(node, &game, search, NULL, 0) != 0) {
+            end_game(&game);
+            return 1;
+        }
+        if (node->edge_count == 0) break;
+
+        int edge = select_edge(worker, node);
+        apply_move(&game, search, mover, node->edges[edge].move);
+        path[depth] = node;
+        edges[depth++] = edge;
+        mover = (mover + 1) % search->player_count;
+
+        int created;
+        ai_node_t *child = find_node(worker, hash_state(&game, search, mover), mover, &created);
+        if (child != NULL && !created && node->edges[edge].visits == 0) worker->transpositions++;
+        node = child;
+        if (created) break;
+    }
+
+    ai_move_t moves[AI_MAX_ACTIONS];
+    for (int ply = 0; ply < search->rollout_depth; ply++) {
+        int count = list_moves(&game, search, mover, moves);
+        if (count > 0) apply_move(&game, search, mover, moves[range_rng(&worker->rng, count)]);
+        mover = (mover + 1) % search->player_count;
+    }
+
+    double rewards[AI_MAX_PLAYERS];
+    score_players(&game, search, rewards);
+    for (int i = 0; i < depth; i++) {
+        ai_edge_t *edge = &path[i]->edges[edges[i]];
+        path[i]->visits++;
+        edge->visits++;
+        edge->reward += rewards[path[i]->mover];
+    }
+
+    end_game(&game);
+    return 0;
+}
+
+/**
+ * @brief Laço de uma thread: executa iterações até o fim do tempo ou das iterações.
+ */
+static void *run_worker(void *arg) {
+    ai_worker_t *worker = (ai_worker_t *) arg;
+    ai_search_t *search = worker->search;
+    // As simulações não entram nas medições de tempo da partida (veja profile.c)
+    PROFILE_PAUSE(profile_state);
+
+    while (!atomic_load(&search->failed)) {
+        if (search->iterations > 0 && atomic_fetch_add(&search->next, 1) >= search->iterations) break;
+        if (search->deadline > 0 && now_ns() >= search->deadline) break;
+        if (run_iteration(worker) != 0) {
+            atomic_store(&search->failed, 1);
+            break;
+        }
+        worker->iterations++;
+    }
+    // A thread atual pode ter partidas vivas nos seus pools; as demais devolvem os blocos
+    if (worker->index > 0) release_pools();
+    PROFILE_RESUME(profile_state);
+    return NULL;
+}
+
+/**
+ * @brief Prepara a árvore de uma thread, com a raiz já expandida.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a memória não puder ser alocada.
+ */
+static int open_worker(ai_worker_t *worker, ai_search_t *search, int index, uint64_t seed) {
+    memset(worker, 0, sizeof(ai_worker_t));
+    worker->search = search;
+    worker->index = index;
+    seed_rng(&worker->rng, seed);
+    for (int i = 0; i < index; i++) jump_rng(&worker->rng);
+
+    size_t table_size = 1;
+    while (table_size < 2 * (size_t) search->node_limit) table_size <<= 1;
+    worker->table_mask = table_size - 1;
+    worker->nodes = (ai_node_t *) malloc((size_t) search->node_limit * sizeof(ai_node_t));
+    worker->table = (int *) malloc(table_size * sizeof(int));
+    if (worker->nodes == NULL || worker->table == NULL) return 1;
+    for (size_t i = 0; i < table_size; i++) worker->table[i] = AI_NO_NODE;
+
+    int created;
+    ai_node_t *root = find_node(worker, search->root_hash, 0, &created);
+    return expand_node(root, search->game, search, search->root_moves, search->root_count);
+}
+
+/**
+ * @brief Libera a árvore de uma thread.
+ */
+static void close_worker(ai_worker_t *worker) {
+    if (worker->nodes != NULL) {
+        for (int i = 0; i < worker->node_count; i++) free(worker->nodes[i].edges);
+    }
+    free(worker->nodes);
+    free(worker->table);
+}
+
+/**
+ * @brief Preenche a configuração padrão: AI_DEFAULT_BUDGET_MS por decisão, uma thread.
+ *
+ * @param config A configuração a ser preenchida.
+ */
+void init_ai_config(ai_config_t *config) {
+    config->budget_ms = AI_DEFAULT_BUDGET_MS;
+    config->iterations = 0;
+    config->threads = 1;
+    config->rollout_depth = 0;
+    config->node_limit = AI_DEFAULT_NODES;
+    config->seed = RNG_DEFAULT_SEED;
+}
+
+/**
+ * @brief Escolhe a próxima ação de uma facção por busca em árvore de Monte Carlo.
+ *
+ * A partida não é alterada: as simulações são feitas em cópias (`fork_game`), que usam
+ * os pools de cada thread da busca. A escolha depende só da partida, da semente e das
+ * iterações quando a busca é limitada por iterações com uma thread; com limite de tempo
+ * ou várias threads, pode variar de uma execução para outra.
+ *
+ * @param game A partida. Não deve ser alterada por outra thread durante a busca.
+ * @param faction O nome da facção que vai agir.
+ * @param config A configuração da busca (veja `init_ai_config`).
+ * @param command Recebe o comando escolhido, pronto para `apply_command`.
+ * @param stats Se não for NULL, recebe as estatísticas da busca.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a facção não existir, não tiver nenhuma
+ *         ação possível ou a memória não puder ser alocada.
+ */
+int choose_action(const game_t *game, const char *faction, const ai_config_t *config, command_t *command, ai_stats_t *stats) {
+    ai_search_t *search = (ai_search_t *) malloc(sizeof(ai_search_t));
+    if (search == NULL) return 1;
+    memset(search, 0, sizeof(ai_search_t));
+    search->game = game;
+
+    // Jogadores na ordem da lista de facções, começando por quem decide
+    const faction_t *self = get_index(&game->faction_index, faction);
+    if (self == NULL) {
+        free(search);
+        return 1;
+    }
+    const faction_t *player = self;
+    do {
+        memcpy(search->players[search->player_count].name, player->name, COMMAND_NAME_LEN);
+        search->players[search->player_count++].id = player->id;
+        player = player->next != NULL ? player->next : game->factions;
+    } while (player != self && search->player_count < AI_MAX_PLAYERS);
+
+    search->root_score = self->power + self->resources;
+    search->root_count = list_moves(game, search, 0, search->root_moves);
+    if (search->root_count == 0) {
+        free(search);
+        return 1;
+    }
+    search->root_hash = hash_state(game, search, 0);
+    search->rollout_depth = config->rollout_depth > 0 ? config->rollout_depth : 4 * search->player_count;
+    search->node_limit = config->node_limit > 0 ? config->node_limit : AI_DEFAULT_NODES;
+    search->iterations = config->iterations;
+    int budget_ms = config->budget_ms > 0 || config->iterations > 0 ? config->budget_ms : AI_DEFAULT_BUDGET_MS;
+    search->deadline = budget_ms > 0 ? now_ns() + (uint64_t) budget_ms * 1000000ull : 0;
+    open_log(&search->log, NULL, 0, 0);
+    atomic_init(&search->next, 0);
+    atomic_init(&search->failed, 0);
+
+    int threads = config->threads;
+    if (threads > AI_MAX_THREADS) threads = AI_MAX_THREADS;
+    if (threads < 1) threads = 1;
+
+    // Cada decisão tem os seus sorteios, derivados da semente e do turno
+    uint64_t seed = config->seed ^ ((uint64_t) game->turns * 0x9E3779B97F4A7C15ull);
+    ai_worker_t workers[threads];
+    int status = 0;
+    for (int i = 0; i < threads; i++) {
+        if (open_worker(&workers[i], search, i, seed) != 0) status = 1;
+    }
+
+    if (status == 0) {
+        pthread_t handles[threads];
+        int started[threads];
+        for (int i = 1; i < threads; i++) {
+            started[i] = pthread_create(&handles[i], NULL, run_worker, &workers[i]) == 0;
+        }
+        // As iterações de threads que não puderam ser criadas ficam com as demais
+        run_worker(&workers[0]);
+        for (int i = 1; i < threads; i++) {
+            if (started[i]) pthread_join(handles[i], NULL);
+        }
+        status = atomic_load(&search->failed);
+    }
+
+    // Soma as visitas de cada ação da raiz; as raízes têm as mesmas ações, na mesma ordem
+    int best = 0;
+    int best_visits = -1;
+    double best_reward = 0.0;
+    if (stats != NULL) memset(stats, 0, sizeof(ai_stats_t));
+    for (int edge = 0; status == 0 && edge < search->root_count; edge++) {
+        int visits = 0;
+        double reward = 0.0;
+        for (int i = 0; i < threads; i++) {
+            visits += workers[i].nodes[0].edges[edge].visits;
+            reward += workers[i].nodes[0].edges[edge].reward;
+        }
+        if (visits > best_visits || (visits == best_visits && reward > best_reward)) {
+            best = edge;
+            best_visits = visits;
+            best_reward = reward;
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        if (stats != NULL) {
+            stats->iterations += workers[i].iterations;
+            stats->nodes += workers[i].node_count;
+            stats->transpositions += workers[i].transpositions;
+        }
+        close_worker(&workers[i]);
+    }
+
+    if (status == 0) make_command(game, search, 0, search->root_moves[best], command);
+    free(search);
+    return status;
+}
@@ -6,14 +6,14 @@
 #include "alliance.h"
 
 /**
- * @brief Aloca memória para uma nova aliança e inicializa seus atributos.
+ * @brief Aloca uma nova aliança do pool de alianças e inicializa seus atributos.
  * 
  * @param name O nome da aliança.
  * @return Um ponteiro para a nova aliança alocada.
  */
 alliance_t *allocate_alliance(char name[15]){
     alliance_t *new_alliance = NULL;
-    new_alliance = (alliance_t *) malloc(sizeof(alliance_t));
+    new_alliance = pool_alloc(POOL_ALLIANCE, sizeof(alliance_t));
     if(new_alliance == NULL) return NULL;
     strcpy(new_alliance->name, name);
     new_alliance->next = NULL;
@@ -38,7 +38,7 @@ void insert_alliance(alliance_t **alliances, char name[15]){
  * @brief Libera a memória alocada para a lista de alianças.
  *
  * A função `free_alliances` percorre a lista encadeada de alianças,
- * liberando a memória alocada para cada nó da lista e ajustando os
+ * devolvendo cada nó da lista ao pool de alianças e ajustando os
  * ponteiros necessários.
  *
  * @param alliances Ponteiro para um ponteiro para o início da lista de alianças.
@@ -47,7 +47,7 @@ void insert_alliance(alliance_t **alliances, char name[15]){
  *
  * @note Certifique-se de que o ponteiro `alliances` aponta para a lista de alianças
  *       corretamente. A função assume que cada nó da lista de alianças foi alocado
- *       dinamicamente (por exemplo, com `malloc`) e precisa ser liberado com `free`.
+ *       com `allocate_alliance`, a partir do pool de alianças.
  *       Após chamar esta função, o ponteiro `alliances` é ajustado para `NULL`,
  *       indicando que a lista está vazia e os recursos foram liberados.
  */
@@ -57,7 +57,7 @@ void free_alliances(alliance_t **alliances) {
     
     while (current != NULL) {
         next = current->next;
-        free(current);  // Libera a memória alocada para o nó atual
+        pool_free(POOL_ALLIANCE, current);  // Devolve o nó atual ao pool de alianças
         current = next; // Avança para o próximo nó
     }
     
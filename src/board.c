@@ -1,11 +1,59 @@
 #include "board.h"
+#include "profile.h"
+
+/**
+ * @brief Calcula a largura, em caracteres, de uma linha impressa do tabuleiro.
+ *
+ * Cada célula ocupa 6 caracteres ("|  XXX" ou "|_____"), seguidos de "|\n" no fim da linha.
+ *
+ * @param board Ponteiro para o tabuleiro.
+ * 
+ * @return Retorna a largura da linha, incluindo a quebra de linha.
+ */
+static size_t board_row_width(const board_t *board) {
+    return (size_t) board->columns * 6 + 2;
+}
+
+/**
+ * @brief Prepara o buffer de impressão do tabuleiro.
+ *
+ * O buffer contém três linhas consecutivas: a borda superior, a linha de células
+ * (cujos símbolos são preenchidos a cada impressão) e a linha separadora. A linha
+ * de células e a separadora ficam adjacentes para serem escritas juntas.
+ *
+ * @param board Ponteiro para o tabuleiro.
+ * 
+ * @return Retorna um ponteiro para o buffer alocado, ou NULL se a alocação falhar.
+ */
+static char *allocate_render(const board_t *board) {
+    size_t width = board_row_width(board);
+    char *buffer = (char *) malloc(width * 3);
+    if (buffer == NULL) return NULL;
+
+    char *top = buffer;
+    char *row = buffer + width;
+    char *separator = buffer + 2 * width;
+
+    memset(top, '_', width - 1);
+    top[width - 1] = '\n';
+    for (int j = 0; j < board->columns; j++) {
+        memcpy(row + j * 6, "|     ", 6);
+        memcpy(separator + j * 6, "|_____", 6);
+    }
+    memcpy(row + width - 2, "|\n", 2);
+    memcpy(separator + width - 2, "|\n", 2);
+
+    return buffer;
+}
 
 /**
  * @brief Cria um novo tabuleiro com as dimensões especificadas.
  *
  * A função `create_board` aloca dinamicamente memória para um novo tabuleiro
- * e inicializa suas dimensões com os valores fornecidos. O tabuleiro criado
- * inicialmente não contém nenhum elemento (a lista `head` é inicializada como NULL).
+ * e para o seu vetor de células. As células são armazenadas de forma contígua,
+ * linha a linha (`line * columns + col`), e começam todas vazias, de modo que
+ * qualquer posição pode ser acessada em tempo constante. O buffer usado por
+ * `print_board` também é preparado aqui, de acordo com o número de colunas.
  *
  * @param lines Número de linhas do tabuleiro.
  * @param columns Número de colunas do tabuleiro.
@@ -15,9 +63,10 @@
  *         
  * @note Certifique-se de liberar a memória alocada para o tabuleiro utilizando
  *       `free_board` quando não precisar mais dele para evitar vazamentos de memória.
- *       O tabuleiro criado contém informações sobre suas dimensões e uma lista inicialmente vazia.
  */
 board_t *create_board(int lines, int columns) {
+    if (lines < 0 || columns < 0) return NULL; // Dimensões inválidas
+    
     board_t *new_board = (board_t *) malloc(sizeof(board_t));
     if (new_board == NULL) return NULL; // Verifica se a alocação de memória foi bem-sucedida
     
@@ -25,17 +74,78 @@ board_t *create_board(int lines, int columns) {
     new_board->lines = lines;
     new_board->columns = columns;
     
-    // Inicializa a lista de elementos do tabuleiro como vazia
-    new_board->head = NULL;
+    // O modo incremental começa desativado (ver `set_board_keyframes`)
+    new_board->keyframe_interval = 0;
+    new_board->frame = 0;
+    new_board->shown = NULL;
+    new_board->dirty = NULL;
+    new_board->dirty_count = 0;
+    
+    // Aloca todas as células de uma vez, já zeradas (sem unidade, prédio ou facção).
+    // A célula extra evita uma alocação de tamanho zero em tabuleiros vazios.
+    new_board->cells = (node_t *) calloc((size_t) lines * (size_t) columns + 1, sizeof(node_t));
+    new_board->render = allocate_render(new_board);
+    if (new_board->cells == NULL || new_board->render == NULL) {
+        free(new_board->cells);
+        free(new_board->render);
+        free(new_board);
+        return NULL;
+    }
+    
+    // Cada célula guarda a própria posição para manter compatibilidade com `node_t`
+    for (int i = 0; i < lines; i++) {
+        for (int j = 0; j < columns; j++) {
+            new_board->cells[(size_t) i * columns + j].line = i;
+            new_board->cells[(size_t) i * columns + j].col = j;
+        }
+    }
     
     return new_board; // Retorna o ponteiro para o tabuleiro criado
 }
 
 /**
- * @brief Aloca memória para um novo nó da lista encadeada.
+ * @brief Obtém a célula do tabuleiro em uma posição específica.
  *
- * A função `allocate_node` aloca dinamicamente memória para um novo nó da lista encadeada
- * (`node_t`) e inicializa seus campos com os valores fornecidos.
+ * A função `get_node_board` calcula o índice `line * columns + col` no vetor de
+ * células do tabuleiro e retorna a célula correspondente em tempo constante.
+ *
+ * @param board Ponteiro para o tabuleiro onde será feita a busca.
+ * @param line Número da linha da célula.
+ * @param col Número da coluna da célula.
+ * 
+ * @return Retorna um ponteiro para a célula na posição especificada, ou NULL se a
+ *         posição estiver fora dos limites do tabuleiro.
+ */
+node_t *get_node_board(board_t *board, int line, int col) {
+    if (board == NULL || line < 0 || col < 0 || line >= board->lines || col >= board->columns) {
+        return NULL; // Posição fora do tabuleiro
+    }
+    return &board->cells[(size_t) line * board->columns + col];
+}
+
+/**
+ * @brief Marca uma célula como alterada desde a última impressão do tabuleiro.
+ *
+ * Só tem efeito quando o modo incremental está ativo (ver `set_board_keyframes`).
+ * Cada célula entra no máximo uma vez na lista de células alteradas.
+ *
+ * @param board Ponteiro para o tabuleiro.
+ * @param cell Ponteiro para a célula alterada, pertencente a `board`.
+ */
+static void mark_dirty(board_t *board, const node_t *cell) {
+    if (board->shown == NULL) return;
+    size_t index = (size_t) (cell - board->cells);
+    if (board->shown[index] & CELL_DIRTY) return;
+    board->shown[index] |= CELL_DIRTY;
+    board->dirty[board->dirty_count++] = (int) index;
+}
+
+/**
+ * @brief Aloca memória para um novo nó avulso.
+ *
+ * A função `allocate_node` aloca dinamicamente memória para um novo nó (`node_t`)
+ * e inicializa seus campos com os valores fornecidos. O tabuleiro não utiliza esta
+ * função para as suas próprias células, que são alocadas de uma vez em `create_board`.
  *
  * @param line Número da linha onde o nó está localizado no tabuleiro.
  * @param col Número da coluna onde o nó está localizado no tabuleiro.
@@ -58,24 +168,21 @@ node_t *allocate_node(int line, int col, unit_t* unit, building_t* building, fac
     // Inicializa os campos do novo nó com os valores fornecidos
     new_node->line = line;
     new_node->col = col;
-    new_node->unit = unit;
-    new_node->unit1 = NULL;
-    new_node->unit2 = NULL;
+    new_node->units = unit;
+    new_node->unit_count = unit != NULL;
     new_node->building = building;
     new_node->faction = faction;
-    new_node->next = NULL;
     
     return new_node; // Retorna o ponteiro para o nó alocado
 }
 
 /**
- * @brief Insere um novo nó na lista encadeada do tabuleiro ou atualiza um nó existente.
+ * @brief Preenche a célula do tabuleiro na posição especificada.
  *
- * A função `insert_node` insere um novo nó na lista encadeada do tabuleiro (`board->head`)
- * ou atualiza um nó existente se já houver um nó na posição especificada (`line`, `col`).
- * Se um nó já existir na posição especificada, ele verifica e atualiza a facção, prédio e unidades
- * associadas a esse nó. Caso contrário, cria um novo nó com os parâmetros fornecidos e insere
- * esse novo nó no início da lista encadeada.
+ * A função `insert_node` acessa diretamente a célula (`line`, `col`) do tabuleiro e
+ * atualiza a facção, o prédio e as unidades associadas a ela. A facção e o prédio só
+ * são definidos se a célula ainda não os possuir, e a unidade é encadeada no início da
+ * lista de unidades da célula, que não tem limite de tamanho.
  *
  * @param board Ponteiro para o tabuleiro onde o nó será inserido.
  * @param line Número da linha onde o nó será inserido/atualizado no tabuleiro.
@@ -84,412 +191,428 @@ node_t *allocate_node(int line, int col, unit_t* unit, building_t* building, fac
  * @param building Ponteiro para o prédio a ser associado ao nó. Pode ser NULL se não houver prédio.
  * @param faction Ponteiro para a facção a ser associada ao nó. Pode ser NULL se não houver facção.
  * 
- * @note Certifique-se de utilizar métodos apropriados para liberar a memória alocada para a lista encadeada
- *       e seus nós quando não forem mais necessários, para evitar vazamentos de memória.
- *       A função assume que a função `allocate_node` é utilizada para criar um novo nó quando necessário.
+ * @note Posições fora dos limites do tabuleiro são ignoradas.
  */
 void insert_node(board_t *board, int line, int col, unit_t *unit, building_t *building, faction_t *faction) {
-    node_t *current = board->head;
+    node_t *current = get_node_board(board, line, col);
+    if (current == NULL) return; // Posição fora do tabuleiro
+    mark_dirty(board, current);
     
-    // Procura por um nó na posição especificada (line, col)
-    while (current != NULL) {
-        if (current->line == line && current->col == col) {
-            // Se o nó já existe na posição, atualiza as informações associadas a ele
-            current->faction = (current->faction == NULL) ? faction : current->faction;
-            current->building = (current->building == NULL) ? building : current->building;
-            
-            // Insere a unidade no primeiro espaço disponível (unit, unit1, unit2)
-            if (current->unit == NULL) {
-                current->unit = unit;
-            } else if (current->unit1 == NULL) {
-                current->unit1 = unit;
-            } else if (current->unit2 == NULL) {
-                current->unit2 = unit;
-            }
-            
-            return; // Retorna após atualizar o nó existente
-        }
-        current = current->next;
-    }
+    current->faction = (current->faction == NULL) ? faction : current->faction;
+    current->building = (current->building == NULL) ? building : current->building;
     
-    // Se não encontrou um nó na posição especificada, cria um novo nó
-    node_t *new_node = allocate_node(line, col, unit, building, faction);
-    if (new_node == NULL) return; // Verifica se a alocação de memória foi bem-sucedida
-    
-    // Insere o novo nó no início da lista encadeada do tabuleiro
-    new_node->next = board->head;
-    board->head = new_node;
+    // Encadeia a unidade no início da lista de unidades da célula
+    if (unit == NULL) return;
+    unit->cell_prev = NULL;
+    unit->cell_next = current->units;
+    if (current->units != NULL) current->units->cell_prev = unit;
+    current->units = unit;
+    current->unit_count++;
+}
+
+/**
+ * @brief Retira uma unidade da célula em que ela está no tabuleiro.
+ *
+ * A função `remove_unit_board` localiza a célula pelas coordenadas da própria unidade e
+ * desencadeia a unidade da lista da célula em tempo constante, usando os ponteiros
+ * `cell_prev` e `cell_next` da própria unidade. A facção e o prédio da célula são
+ * mantidos. A unidade não é liberada.
+ *
+ * @param board Ponteiro para o tabuleiro.
+ * @param unit Ponteiro para a unidade a ser retirada.
+ * 
+ * @return Retorna 0 se a unidade foi retirada da célula, ou 1 se ela não estava no tabuleiro.
+ */
+int remove_unit_board(board_t *board, unit_t *unit) {
+    node_t *current = get_node_board(board, unit->x, unit->y);
+    if (current == NULL) return 1; // Posição fora do tabuleiro
+
+    if (unit->cell_prev == NULL && current->units != unit) {
+        return 1; // A unidade não está encadeada nesta célula
+    }
+
+    if (unit->cell_prev != NULL) unit->cell_prev->cell_next = unit->cell_next;
+    else current->units = unit->cell_next;
+    if (unit->cell_next != NULL) unit->cell_next->cell_prev = unit->cell_prev;
+    unit->cell_prev = NULL;
+    unit->cell_next = NULL;
+    current->unit_count--;
+
+    mark_dirty(board, current);
+    return 0;
+}
+
+/**
+ * @brief Move uma unidade para outra célula do tabuleiro.
+ *
+ * A função `move_unit` retira a unidade da célula atual com `remove_unit_board` e a coloca
+ * na lista de unidades da célula de destino, atualizando suas coordenadas. Nenhuma
+ * célula ou unidade é alocada ou liberada, e as duas células são acessadas diretamente.
+ *
+ * @param board Ponteiro para o tabuleiro.
+ * @param unit Ponteiro para a unidade a ser movida.
+ * @param line Linha de destino.
+ * @param col Coluna de destino.
+ * 
+ * @note Se a célula de destino estiver fora do tabuleiro, a unidade recebe as novas
+ *       coordenadas mas não ocupa nenhuma célula, como em `insert_node`.
+ */
+void move_unit(board_t *board, unit_t *unit, int line, int col) {
+    remove_unit_board(board, unit);
+    unit->x = line;
+    unit->y = col;
+    insert_node(board, line, col, unit, NULL, NULL);
 }
 
 /**
  * @brief Obtém a facção associada a um nó específico do tabuleiro.
  *
- * A função `get_faction_board` percorre a lista encadeada do tabuleiro (`board->head`)
- * procurando por um nó na posição especificada (`line`, `col`). Se encontrar um nó nessa
- * posição, retorna o ponteiro para a facção associada a esse nó. Caso contrário, retorna NULL.
+ * A função `get_faction_board` acessa diretamente a célula na posição especificada
+ * (`line`, `col`) e retorna o ponteiro para a facção associada a ela.
  *
  * @param board Ponteiro para o tabuleiro onde será feita a busca.
  * @param line Número da linha onde o nó está localizado no tabuleiro.
  * @param col Número da coluna onde o nó está localizado no tabuleiro.
  * 
  * @return Retorna um ponteiro para a facção associada ao nó encontrado na posição especificada.
- *         Se não encontrar um nó na posição especificada, retorna NULL.
+ *         Se a posição estiver fora do tabuleiro, retorna NULL.
  *         
- * @note Esta função não aloca memória adicional. A facção retornada pertence ao nó encontrado na posição especificada.
- *       Certifique-se de utilizar métodos apropriados para liberar a memória alocada para a lista encadeada e seus nós
- *       quando não forem mais necessários, para evitar vazamentos de memória.
+ * @note Esta função não aloca memória adicional e executa em tempo constante.
  */
 faction_t *get_faction_board(board_t *board, int line, int col) {
-    node_t *current = board->head;
-    
-    // Percorre a lista encadeada procurando por um nó na posição (line, col)
-    while (current != NULL) {
-        if (current->line == line && current->col == col) {
-            return current->faction; // Retorna a facção associada ao nó encontrado
-        }
-        current = current->next;
-    }
-    
-    return NULL; // Retorna NULL se não encontrar um nó na posição especificada
+    node_t *current = get_node_board(board, line, col);
+    return current != NULL ? current->faction : NULL; // NULL se a posição estiver fora do tabuleiro
 }
 
 /**
  * @brief Obtém o prédio associado a um nó específico do tabuleiro.
  *
- * A função `get_building_board` percorre a lista encadeada do tabuleiro (`board->head`)
- * procurando por um nó na posição especificada (`line`, `col`). Se encontrar um nó nessa
- * posição, retorna o ponteiro para o prédio associado a esse nó. Caso contrário, retorna NULL.
+ * A função `get_building_board` acessa diretamente a célula na posição especificada
+ * (`line`, `col`) e retorna o ponteiro para o prédio associado a ela.
  *
  * @param board Ponteiro para o tabuleiro onde será feita a busca.
  * @param line Número da linha onde o nó está localizado no tabuleiro.
  * @param col Número da coluna onde o nó está localizado no tabuleiro.
  * 
  * @return Retorna um ponteiro para o prédio associado ao nó encontrado na posição especificada.
- *         Se não encontrar um nó na posição especificada, retorna NULL.
+ *         Se a posição estiver fora do tabuleiro, retorna NULL.
  *         
- * @note Esta função não aloca memória adicional. O prédio retornado pertence ao nó encontrado na posição especificada.
- *       Certifique-se de utilizar métodos apropriados para liberar a memória alocada para a lista encadeada e seus nós
- *       quando não forem mais necessários, para evitar vazamentos de memória.
+ * @note Esta função não aloca memória adicional e executa em tempo constante.
  */
-building_t *get_building_board(board_t *board, int line, int col){
-    node_t *current = board->head;
-    // Percorre a lista encadeada procurando por um nó na posição (line, col)
-    while(current != NULL){
-        if(current->line == line && current->col == col){
-            return current->building;
-        }
-        current = current->next;
-    }
-    return 0;
+building_t *get_building_board(board_t *board, int line, int col) {
+    node_t *current = get_node_board(board, line, col);
+    return current != NULL ? current->building : NULL; // NULL se a posição estiver fora do tabuleiro
 }
 
 /**
  * @brief Obtém a unidade associada a um nó específico do tabuleiro.
  *
- * A função `get_unit_board` percorre a lista encadeada do tabuleiro (`board->head`)
- * procurando por um nó na posição especificada (`line`, `col`). Se encontrar um nó nessa
- * posição, retorna o ponteiro para a unidade associada a esse nó. Caso contrário, retorna NULL.
+ * A função `get_unit_board` acessa diretamente a célula na posição especificada
+ * (`line`, `col`) e retorna o ponteiro para a primeira unidade da lista de unidades da célula.
  *
  * @param board Ponteiro para o tabuleiro onde será feita a busca.
  * @param line Número da linha onde o nó está localizado no tabuleiro.
  * @param col Número da coluna onde o nó está localizado no tabuleiro.
  * 
  * @return Retorna um ponteiro para a unidade associada ao nó encontrado na posição especificada.
- *         Se não encontrar um nó na posição especificada, retorna NULL.
+ *         Se a posição estiver fora do tabuleiro, retorna NULL.
  *         
- * @note Esta função não aloca memória adicional. A unidade retornada pertence ao nó encontrado na posição especificada.
- *       Certifique-se de utilizar métodos apropriados para liberar a memória alocada para a lista encadeada e seus nós
- *       quando não forem mais necessários, para evitar vazamentos de memória.
+ * @note Esta função não aloca memória adicional e executa em tempo constante.
  */
-unit_t *get_unit_board(board_t *board, int line, int col){
-    node_t *current = board->head;
-    // Percorre a lista encadeada procurando por um nó na posição (line, col)
-    while(current != NULL){
-        if(current->line == line && current->col == col){
-            return current->unit;
-        }
-        current = current->next;
-    }
-    return 0;
+unit_t *get_unit_board(board_t *board, int line, int col) {
+    node_t *current = get_node_board(board, line, col);
+    return current != NULL ? current->units : NULL; // NULL se a posição estiver fora do tabuleiro
 }
 
 /**
- * @brief Obtém a primeira unidade adicional associada a um nó específico do tabuleiro.
+ * @brief Obtém a segunda unidade da lista de um nó específico do tabuleiro.
  *
- * A função `get_unit1_board` percorre a lista encadeada do tabuleiro (`board->head`)
- * procurando por um nó na posição especificada (`line`, `col`). Se encontrar um nó nessa
- * posição, retorna o ponteiro para a primeira unidade adicional associada a esse nó.
- * Caso contrário, retorna NULL.
+ * A função `get_unit1_board` acessa diretamente a célula na posição especificada
+ * (`line`, `col`) e retorna o ponteiro para a segunda unidade da lista da célula.
+ * Para percorrer todas as unidades, use `get_unit_board` e siga `cell_next`.
  *
  * @param board Ponteiro para o tabuleiro onde será feita a busca.
  * @param line Número da linha onde o nó está localizado no tabuleiro.
  * @param col Número da coluna onde o nó está localizado no tabuleiro.
  * 
- * @return Retorna um ponteiro para a primeira unidade adicional associada ao nó encontrado na posição especificada.
- *         Se não encontrar um nó na posição especificada, retorna NULL.
+ * @return Retorna um ponteiro para a segunda unidade da célula na posição especificada, ou NULL se não houver.
+ *         Se a posição estiver fora do tabuleiro, retorna NULL.
  *         
- * @note Esta função não aloca memória adicional. A unidade retornada pertence ao nó encontrado na posição especificada.
- *       Certifique-se de utilizar métodos apropriados para liberar a memória alocada para a lista encadeada e seus nós
- *       quando não forem mais necessários, para evitar vazamentos de memória.
+ * @note Esta função não aloca memória adicional e executa em tempo constante.
  */
-unit_t *get_unit1_board(board_t *board, int line, int col){
-    node_t *current = board->head;
-    // Percorre a lista encadeada procurando por um nó na posição (line, col)
-    while(current != NULL){
-        if(current->line == line && current->col == col){
-            return current->unit1; // Retorna a primeira unidade adicional associada ao nó encontrado
-        }
-        current = current->next;
-    }
-    return 0;
+unit_t *get_unit1_board(board_t *board, int line, int col) {
+    node_t *current = get_node_board(board, line, col);
+    if (current == NULL || current->units == NULL) return NULL;
+    return current->units->cell_next;
 }
 
 /**
- * @brief Obtém a segunda unidade adicional associada a um nó específico do tabuleiro.
+ * @brief Obtém a terceira unidade da lista de um nó específico do tabuleiro.
  *
- * A função `get_unit2_board` percorre a lista encadeada do tabuleiro (`board->head`)
- * procurando por um nó na posição especificada (`line`, `col`). Se encontrar um nó nessa
- * posição, retorna o ponteiro para a segunda unidade adicional associada a esse nó.
- * Caso contrário, retorna NULL.
+ * A função `get_unit2_board` acessa diretamente a célula na posição especificada
+ * (`line`, `col`) e retorna o ponteiro para a terceira unidade da lista da célula.
  *
  * @param board Ponteiro para o tabuleiro onde será feita a busca.
  * @param line Número da linha onde o nó está localizado no tabuleiro.
  * @param col Número da coluna onde o nó está localizado no tabuleiro.
  * 
- * @return Retorna um ponteiro para a segunda unidade adicional associada ao nó encontrado na posição especificada.
- *         Se não encontrar um nó na posição especificada, retorna NULL.
+ * @return Retorna um ponteiro para a terceira unidade da célula na posição especificada, ou NULL se não houver.
+ *         Se a posição estiver fora do tabuleiro, retorna NULL.
  *         
- * @note Esta função não aloca memória adicional. A unidade retornada pertence ao nó encontrado na posição especificada.
- *       Certifique-se de utilizar métodos apropriados para liberar a memória alocada para a lista encadeada e seus nós
- *       quando não forem mais necessários, para evitar vazamentos de memória.
+ * @note Esta função não aloca memória adicional e executa em tempo constante.
  */
-unit_t *get_unit2_board(board_t *board, int line, int col){
-    node_t *current = board->head;
-    // Percorre a lista encadeada procurando por um nó na posição (line, col)
-    while(current != NULL){
-        if(current->line == line && current->col == col){
-            return current->unit2;// Retorna a segunda unidade adicional associada ao nó encontrado
-        }
-        current = current->next;
-    }
-    return 0;
+unit_t *get_unit2_board(board_t *board, int line, int col) {
+    node_t *current = get_node_board(board, line, col);
+    if (current == NULL || current->units == NULL || current->units->cell_next == NULL) return NULL;
+    return current->units->cell_next->cell_next;
 }
 
 
 
 /**
- * @brief Remove um nó específico do tabuleiro, liberando sua memória.
+ * @brief Esvazia uma célula específica do tabuleiro.
  *
- * A função `remove_node` percorre a lista encadeada do tabuleiro (`board->head`)
- * procurando por um nó na posição especificada (`row`, `col`). Se encontrar um nó nessa
- * posição, remove o nó da lista encadeada, ajustando os ponteiros adequados e liberando
- * sua memória. Caso contrário, a função não faz nada.
+ * A função `remove_node` acessa diretamente a célula na posição especificada (`row`, `col`)
+ * e remove a facção, o prédio e as unidades associados a ela. A célula continua pertencendo
+ * ao vetor do tabuleiro, portanto nenhuma memória é liberada.
  *
  * @param board Ponteiro para o tabuleiro onde será removido o nó.
  * @param row Número da linha onde o nó está localizado no tabuleiro.
  * @param col Número da coluna onde o nó está localizado no tabuleiro.
  * 
- * @note Esta função libera a memória alocada para o nó removido. Certifique-se de não utilizar
- *       o nó removido após chamar esta função para evitar comportamento indefinido.
+ * @note Posições fora dos limites do tabuleiro são ignoradas.
  */
 void remove_node(board_t *board, int row, int col) {
-    node_t *current = board->head;
-    node_t *prev = NULL;
-
-    // Percorre a lista encadeada procurando por um nó na posição (row, col)
-    while (current != NULL) {
-        if (current->line == row && current->col == col) {
-            if (prev == NULL) {
-                board->head = current->next; // Atualiza o ponteiro head se o nó removido for o primeiro da lista
-            } else {
-                prev->next = current->next; // Liga o nó anterior ao próximo nó após o nó removido
-            }
-            free(current); // Libera a memória alocada para o nó removido
-            return;
+    node_t *current = get_node_board(board, row, col);
+    if (current == NULL) return; // Posição fora do tabuleiro
+    mark_dirty(board, current);
+
+    // Desencadeia as unidades da célula; elas continuam existindo na lista de unidades
+    unit_t *unit = current->units;
+    while (unit != NULL) {
+        unit_t *next = unit->cell_next;
+        unit->cell_prev = NULL;
+        unit->cell_next = NULL;
+        unit = next;
+    }
+    current->units = NULL;
+    current->unit_count = 0;
+    current->building = NULL;
+    current->faction = NULL;
+}
+
+/**
+ * @brief Ativa a impressão incremental do tabuleiro.
+ *
+ * A função `set_board_keyframes` faz com que `print_board` passe a registrar apenas as
+ * células alteradas desde a impressão anterior, escrevendo o tabuleiro completo (quadro-chave)
+ * a cada `interval` impressões. Para isso, o tabuleiro passa a guardar o símbolo exibido
+ * de cada célula e a lista das células alteradas.
+ *
+ * @param board Ponteiro para o tabuleiro.
+ * @param interval Número de impressões entre dois quadros-chave. Valores menores ou iguais
+ *                 a zero mantêm a impressão completa a cada chamada.
+ * 
+ * @return Retorna 0 se o modo foi configurado com sucesso. Retorna 1 se houver falha na
+ *         alocação de memória, caso em que o tabuleiro continua no modo completo.
+ */
+int set_board_keyframes(board_t *board, int interval) {
+    if (interval <= 0) {
+        board->keyframe_interval = 0;
+        return 0;
+    }
+
+    if (board->shown == NULL) {
+        size_t cells = (size_t) board->lines * board->columns + 1;
+        board->shown = (unsigned char *) calloc(cells, sizeof(unsigned char));
+        board->dirty = (int *) malloc(cells * sizeof(int));
+        if (board->shown == NULL || board->dirty == NULL) {
+            free(board->shown);
+            free(board->dirty);
+            board->shown = NULL;
+            board->dirty = NULL;
+            return 1;
         }
-        prev = current;
-        current = current->next;
+        board->dirty_count = 0;
     }
+
+    board->keyframe_interval = interval;
+    board->frame = 0; // A próxima impressão é um quadro-chave
+    return 0;
 }
 
 /**
- * @brief Libera toda a memória alocada para o tabuleiro e seus nós.
+ * @brief Copia um tabuleiro, com o estado da impressão incremental.
+ *
+ * As células são copiadas de uma só vez e continuam apontando para as facções, os
+ * prédios e as unidades do tabuleiro original; quem copia esses objetos deve atualizar
+ * os ponteiros (veja `fork_game`).
  *
- * A função `free_board` libera a memória alocada para todos os nós da lista encadeada
- * do tabuleiro (`board->head`), incluindo o próprio tabuleiro. Após chamar esta função,
- * o ponteiro `board` não deve ser utilizado, pois sua memória também é liberada.
+ * @param board Ponteiro para o tabuleiro copiado.
  *
- * @param board Ponteiro para o tabuleiro que será liberado da memória.
+ * @return Retorna um ponteiro para a cópia, ou NULL se houver falha na alocação de memória.
+ */
+board_t *copy_board(const board_t *board) {
+    board_t *copy = create_board(board->lines, board->columns);
+    if (copy == NULL) return NULL;
+
+    size_t cells = (size_t) board->lines * board->columns;
+    memcpy(copy->cells, board->cells, cells * sizeof(node_t));
+    if (board->shown != NULL) {
+        if (set_board_keyframes(copy, 1) != 0) {
+            free_board(copy);
+            free(copy);
+            return NULL;
+        }
+        memcpy(copy->shown, board->shown, cells + 1);
+        memcpy(copy->dirty, board->dirty, board->dirty_count * sizeof(int));
+        copy->dirty_count = board->dirty_count;
+    }
+    copy->keyframe_interval = board->keyframe_interval;
+    copy->frame = board->frame;
+    return copy;
+}
+
+/**
+ * @brief Libera a memória alocada para as células do tabuleiro.
+ *
+ * A função `free_board` libera o vetor de células, o buffer de impressão e o controle de
+ * células alteradas do tabuleiro. A estrutura
+ * `board_t` em si deve ser liberada por quem a criou, com `free`.
+ *
+ * @param board Ponteiro para o tabuleiro cujas células serão liberadas.
  * 
- * @note Esta função não retorna nenhum valor, pois seu objetivo é liberar a memória
- *       alocada para o tabuleiro e seus nós. Após chamar esta função, o ponteiro `board`
- *       não deve mais ser utilizado para evitar comportamento indefinido.
+ * @note Após chamar esta função, as células do tabuleiro não devem mais ser acessadas.
  */
 void free_board(board_t *board){
-    node_t *current = board->head;
-    while(current != NULL){
-        node_t *temp = current;
-        current = current->next;
-        free(temp); // Libera a memória alocada para o nó atual
+    free(board->cells);
+    free(board->render);
+    free(board->shown);
+    free(board->dirty);
+    board->cells = NULL;
+    board->render = NULL;
+    board->shown = NULL;
+    board->dirty = NULL;
+    board->dirty_count = 0;
+    board->lines = 0;
+    board->columns = 0;
+}
+/**
+ * @brief Símbolos de uma linha da tabela de ocupação: 0 a 9 unidades e "+" para 10 ou mais.
+ */
+#define GLYPH_COUNTS(f, b) \
+    f " " b, f "U" b, f "2" b, f "3" b, f "4" b, f "5" b, f "6" b, f "7" b, f "8" b, f "9" b, f "+" b
+
+#define GLYPH_MAX_COUNT 10
+
+/**
+ * @brief Símbolos de cada combinação de ocupação de uma célula.
+ *
+ * A tabela é indexada pela máscara de ocupação da célula, `(facção * 2 + prédio) * 11 + unidades`,
+ * onde a quantidade de unidades é limitada a 10 ("+"). Cada símbolo ocupa exatamente 3 caracteres:
+ * a facção, a quantidade de unidades ("U" para uma) e o prédio.
+ */
+static const char board_glyphs[4 * (GLYPH_MAX_COUNT + 1)][4] = {
+    GLYPH_COUNTS(" ", " "),    // Apenas unidades
+    GLYPH_COUNTS(" ", "B"),    // Prédio
+    GLYPH_COUNTS("F", " "),    // Facção
+    GLYPH_COUNTS("F", "B")     // Facção e prédio
+};
+
+/**
+ * @brief Calcula a máscara de ocupação de uma célula do tabuleiro.
+ *
+ * @param cell Ponteiro para a célula.
+ * 
+ * @return Retorna o índice da célula na tabela `board_glyphs`.
+ */
+static int board_cell_mask(const node_t *cell) {
+    int units = cell->unit_count < GLYPH_MAX_COUNT ? cell->unit_count : GLYPH_MAX_COUNT;
+    int occupancy = (cell->faction != NULL) << 1 | (cell->building != NULL);
+    return occupancy * (GLYPH_MAX_COUNT + 1) + units;
+}
+
+/**
+ * @brief Imprime todas as células do tabuleiro.
+ *
+ * Cada linha do tabuleiro é montada no buffer do tabuleiro e escrita no log de uma só vez,
+ * junto com a linha separadora. Se o modo incremental estiver ativo, o símbolo de cada
+ * célula é registrado como exibido e a lista de células alteradas é esvaziada.
+ *
+ * @param log O log da partida, onde o tabuleiro será impresso.
+ * @param board Ponteiro para o tabuleiro que será impresso.
+ */
+static void print_board_full(log_t *log, board_t *board) {
+    size_t width = board_row_width(board);
+    char *row = board->render + width;
+
+    write_log(log, LOG_BOARD, board->render, width); // Borda superior
+    for (int i = 0; i < board->lines; i++) {
+        size_t first = (size_t) i * board->columns;
+        const node_t *cell = &board->cells[first];
+        for (int j = 0; j < board->columns; j++) {
+            int mask = board_cell_mask(&cell[j]);
+            if (board->shown != NULL) board->shown[first + j] = (unsigned char) mask;
+            memcpy(row + j * 6 + 3, board_glyphs[mask], 3);
+        }
+        write_log(log, LOG_BOARD, row, width * 2); // Linha de células seguida da linha separadora
+    }
+    board->dirty_count = 0;
+}
+
+/**
+ * @brief Imprime apenas as células cujo símbolo mudou desde a última impressão.
+ *
+ * Cada célula alterada é escrita em uma linha no formato `(linha, coluna) [XXX]`,
+ * onde `XXX` é o novo símbolo da célula. Células marcadas como alteradas mas que
+ * voltaram ao símbolo já exibido não são escritas.
+ *
+ * @param log O log da partida, onde as alterações serão impressas.
+ * @param board Ponteiro para o tabuleiro.
+ */
+static void print_board_diff(log_t *log, board_t *board) {
+    for (int k = 0; k < board->dirty_count; k++) {
+        int index = board->dirty[k];
+        int mask = board_cell_mask(&board->cells[index]);
+        if (mask != (board->shown[index] & CELL_MASK)) {
+            print_log(log, LOG_BOARD, "(%d, %d) [%s]\n", index / board->columns, index % board->columns, board_glyphs[mask]);
+        }
+        board->shown[index] = (unsigned char) mask;
     }
+    board->dirty_count = 0;
 }
+
 /**
- * @brief Imprime o estado atual do tabuleiro em um arquivo de log.
+ * @brief Imprime o estado atual do tabuleiro no log da partida.
  *
- * A função `print_board` imprime o estado atual do tabuleiro em um arquivo de log
- * chamado "saida.txt". Cada célula do tabuleiro é representada por um conjunto de
- * caracteres que indicam a presença de unidades, construções e facções.
+ * No modo padrão, a função `print_board` escreve o tabuleiro completo a cada chamada.
+ * Com o modo incremental ativo (`set_board_keyframes`), cada impressão é um quadro
+ * numerado: a cada `keyframe_interval` quadros o tabuleiro é escrito por completo, e
+ * nos demais apenas as células alteradas desde o quadro anterior. O tabuleiro de
+ * qualquer quadro pode ser reconstruído a partir do último quadro-chave e das
+ * diferenças seguintes (ver `tools/replay.c`).
  *
+ * @param log O log da partida, onde o tabuleiro será impresso.
  * @param board Ponteiro para o tabuleiro que será impresso.
  * 
- * @note Esta função não retorna nenhum valor. Ela abre o arquivo "saida.txt" no modo
- *       de adição ("a"), escreve o estado do tabuleiro no arquivo e fecha o arquivo
- *       após a impressão.
+ * @note Esta função não retorna nenhum valor e não aloca memória: o buffer de
+ *       impressão é preparado uma única vez em `create_board`. Se a categoria
+ *       LOG_BOARD estiver desativada no log, nada é feito.
  */
-void print_board(FILE *log, board_t *board){
-    fprintf(log, "_____________________________________________________________\n");
-    for(int i = 0; i < board->lines; i++){
-        for(int j = 0; j < board->columns; j++){
-            fprintf(log, "|  ");
-            if(
-                get_unit_board(board, i, j) && 
-                get_unit1_board(board, i, j) &&
-                get_unit2_board(board, i, j) && 
-                get_building_board(board, i, j) && 
-                get_faction_board(board, i, j)
-            ) fprintf(log, "F3B ");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_unit1_board(board, i, j) &&
-                get_building_board(board, i, j) && 
-                get_faction_board(board, i, j)
-            ) fprintf(log, "F2B");
-            else if(
-                get_unit1_board(board, i, j) && 
-                get_unit2_board(board, i, j) &&
-                get_building_board(board, i, j) && 
-                get_faction_board(board, i, j)
-            ) fprintf(log, "F2B");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_unit2_board(board, i, j) &&
-                get_building_board(board, i, j) && 
-                get_faction_board(board, i, j)
-            ) fprintf(log, "F2B");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_unit1_board(board, i, j) &&
-                get_unit2_board(board, i, j) && 
-                get_faction_board(board, i, j)
-            ) fprintf(log, "F3 ");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_unit1_board(board, i, j) &&
-                get_faction_board(board, i, j)
-            ) fprintf(log, "F2 ");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_unit2_board(board, i, j) &&
-                get_faction_board(board, i, j)
-            ) fprintf(log, "F2 ");
-            else if(
-                get_unit1_board(board, i, j) && 
-                get_unit2_board(board, i, j) &&
-                get_faction_board(board, i, j)
-            ) fprintf(log, "F2 ");
-            else if(
-                get_unit_board(board, i, j) &&
-                get_faction_board(board, i, j)
-            ) fprintf(log, "FU ");
-            else if(
-                get_unit1_board(board, i, j) &&
-                get_faction_board(board, i, j)
-            ) fprintf(log, "FU ");
-            else if(
-                get_unit2_board(board, i, j) &&
-                get_faction_board(board, i, j)
-            ) fprintf(log, "FU ");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_unit1_board(board, i, j) &&
-                get_building_board(board, i, j)
-            ) fprintf(log, " 2B");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_unit2_board(board, i, j) &&
-                get_building_board(board, i, j)
-            ) fprintf(log, " 2B");
-            else if(
-                get_unit1_board(board, i, j) && 
-                get_unit2_board(board, i, j) &&
-                get_building_board(board, i, j)
-            ) fprintf(log, " 2B");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_building_board(board, i, j)
-            ) fprintf(log, " UB");
-            else if(
-                get_unit1_board(board, i, j) && 
-                get_building_board(board, i, j)
-            ) fprintf(log, " UB");
-            else if(
-                get_unit2_board(board, i, j) && 
-                get_building_board(board, i, j)
-            ) fprintf(log, " UB");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_unit1_board(board, i, j) &&
-                get_unit2_board(board, i, j)
-            ) fprintf(log, " 3 ");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_unit1_board(board, i, j)
-            ) fprintf(log, " 2 ");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_unit2_board(board, i, j)
-            ) fprintf(log, " 2 ");
-            else if(
-                get_unit1_board(board, i, j) && 
-                get_unit2_board(board, i, j)
-            ) fprintf(log, " 2 ");
-            else if(
-                get_unit_board(board, i, j) && 
-                get_building_board(board, i, j) && 
-                get_faction_board(board, i, j)
-            ) fprintf(log, "FUB");
-            else if(
-                get_unit1_board(board, i, j) && 
-                get_building_board(board, i, j) && 
-                get_faction_board(board, i, j)
-            ) fprintf(log, "FUB");
-            else if(
-                get_unit2_board(board, i, j) && 
-                get_building_board(board, i, j) && 
-                get_faction_board(board, i, j)
-            ) fprintf(log, "FUB");
-            else if(
-                get_building_board(board, i, j) && 
-                get_faction_board(board, i, j)
-            ) fprintf(log, "F B");
-            else if(
-                get_faction_board(board, i, j)
-            ) fprintf(log, "F  ");
-            else if(
-                get_building_board(board, i, j)
-            ) fprintf(log, "  B");
-            else if(
-                get_unit_board(board, i, j)
-            ) fprintf(log, " U ");
-            else if(
-                get_unit1_board(board, i, j)
-            ) fprintf(log, " U ");
-            else if(
-                get_unit2_board(board, i, j)
-            ) fprintf(log, " U ");
-            else fprintf(log, "   ");
-        }
-        fprintf(log, "|\n");
-        fprintf(log, "|_____|_____|_____|_____|_____|_____|_____|_____|_____|_____|\n");
+void print_board(log_t *log, board_t *board){
+    if (board->render == NULL || !LOG_ENABLED(log, LOG_BOARD)) return;
+    PROFILE_BEGIN(start);
+
+    if (board->keyframe_interval <= 0) {
+        print_board_full(log, board);
+    } else if (board->frame % board->keyframe_interval == 0) {
+        print_log(log, LOG_BOARD, "=== Quadro %d (completo) ===\n", board->frame);
+        print_board_full(log, board);
+        board->frame++;
+    } else {
+        print_log(log, LOG_BOARD, "=== Quadro %d (diferença) ===\n", board->frame);
+        print_board_diff(log, board);
+        board->frame++;
     }
-}
\ No newline at end of file
+    PROFILE_END(PROFILE_BOARD, start);
+}
@@ -1,7 +1,7 @@
 #include "building.h"
 
 /**
- * Aloca memória para uma nova estrutura de edifício e inicializa seus campos.
+ * Aloca uma nova estrutura de edifício do pool de prédios e inicializa seus campos.
  * 
  * @param x A coordenada x do edifício.
  * @param y A coordenada y do edifício.
@@ -10,7 +10,7 @@
  */
 building_t *allocate_building(int x, int y, char name[15], building_e type){       //Esta função aloca memória para uma nova instância de um edifício, inicializa suas coordenadas e tipo.
     building_t *new_building = NULL;
-    new_building = (building_t *) malloc(sizeof(building_t));
+    new_building = pool_alloc(POOL_BUILDING, sizeof(building_t));
     if(new_building == NULL) return NULL;
     strcpy(new_building->name, name);
     new_building->x = x;
@@ -41,19 +41,19 @@ void insert_building(building_t **buildings, int x, int y, char name[15],  build
  *
  * A função `free_buildings` libera a memória alocada para a lista encadeada de
  * construções (`building_t`). Ela percorre a lista encadeada a partir do início
- * indicado por `*buildings`, libera cada nó da lista e atualiza o ponteiro `*buildings`
+ * indicado por `*buildings`, devolve cada nó ao pool de prédios e atualiza o ponteiro `*buildings`
  * para apontar para NULL após liberar todos os nós.
  *
  * @param buildings Ponteiro para o ponteiro da lista encadeada de construções.
  *                  Após a execução da função, `*buildings` será NULL.
  * 
- * @note Esta função não retorna nenhum valor. Ela libera a memória alocada dinamicamente
- *       para cada nó da lista encadeada de construções, incluindo o próprio nó.
+ * @note Esta função não retorna nenhum valor. A memória dos nós continua reservada no pool
+ *       de prédios e é reaproveitada pelas próximas construções.
  */
 void free_buildings(building_t **buildings){
     while(*buildings != NULL){
         building_t *temp = *buildings;      // Armazena o nó atual em `temp`
         *buildings = (*buildings)->next;    // Atualiza `*buildings` para o próximo nó
-        free(temp);                         // Libera a memória do nó atual
+        pool_free(POOL_BUILDING, temp);     // Devolve o nó atual ao pool de prédios
     }
 }
\ No newline at end of file
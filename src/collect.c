@@ -0,0 +1,144 @@
+/**
+ * @file collect.c
+ * @brief Coleta de recursos em lote, sobre o armazenamento em arrays das unidades.
+ *
+ * O rendimento de uma coleta depende apenas do tipo da unidade e do terreno onde ela
+ * está. Em vez de ramificar sobre os dois, o rendimento é lido de uma tabela indexada
+ * por `(tipo << 2) | terreno`, o que permite calcular oito unidades de uma vez com
+ * AVX2: as posições, o terreno e o rendimento são buscados com instruções de gather.
+ * A versão AVX2 é escolhida em tempo de execução quando o processador a suporta e o
+ * mapa tem no máximo INT_MAX bytes (as posições das células são de 32 bits); nos
+ * demais casos (e nas unidades que sobram ao final do lote) é usada a versão escalar,
+ * que produz exatamente os mesmos resultados.
+ */
+
+#include "collect.h"
+
+#include <limits.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define COLLECT_HAS_AVX2 1
+#endif
+
+/**
+ * @brief Rendimento de uma coleta, indexado por `(tipo << 2) | terreno`.
+ *
+ * Tipos e terrenos desconhecidos (inclusive TERRAIN_NONE) rendem 0.
+ */
+static const int collect_yields[16] = {
+    0, 0, 0, 0,                 // Sem tipo
+    30, 20, 10, 0,              // SOLDIER: planície, floresta, montanha
+    50, 40, 30, 0,              // EXPLORER: planície, floresta, montanha
+    0, 0, 0, 0,
+};
+
+/**
+ * @brief Soma os rendimentos de um trecho do lote, já calculados, aos totais das facções.
+ */
+static void add_totals(const unit_store_t *store, const int *handles, const int *yields, int count, int *totals, int faction_count) {
+    for (int i = 0; i < count; i++) {
+        int faction = store->faction_id[handles[i]];
+        if (faction >= 0 && faction < faction_count) totals[faction] += yields[i];
+    }
+}
+
+/**
+ * @brief Calcula a coleta de um lote de unidades, uma unidade por vez.
+ *
+ * Mesmos parâmetros e resultados de `collect_units`, sem instruções vetoriais.
+ */
+void collect_units_scalar(const unit_store_t *store, const int *handles, int count, const terrain_t *terrain,
+                          int *yields, int *totals, int faction_count) {
+    for (int i = 0; i < count; i++) {
+        int handle = handles[i];
+        int cell = get_terrain(terrain, store->x[handle], store->y[handle]);
+        int type = store->type[handle] <= EXPLORER ? store->type[handle] : 0;
+        int yield = collect_yields[(type << 2) | (cell & 3)];
+
+        if (yields != NULL) yields[i] = yield;
+        if (totals != NULL) {
+            int faction = store->faction_id[handle];
+            if (faction >= 0 && faction < faction_count) totals[faction] += yield;
+        }
+    }
+}
+
+#ifdef COLLECT_HAS_AVX2
+/**
+ * @brief Calcula a coleta de um lote de unidades, oito por vez, com AVX2.
+ *
+ * @return A quantidade de unidades processadas (múltiplo de 8); o restante fica para a versão escalar.
+ */
+__attribute__((target("avx2")))
+static int collect_units_avx2(const unit_store_t *store, const int *handles, int count, const terrain_t *terrain,
+                              int *yields, int *totals, int faction_count) {
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i type_limit = _mm256_set1_epi32(EXPLORER + 1);
+    const __m256i byte = _mm256_set1_epi32(0xFF);
+    const __m256i max_x = _mm256_set1_epi32(terrain->lines);
+    const __m256i max_y = _mm256_set1_epi32(terrain->columns);
+    const __m256i no_terrain = _mm256_set1_epi32(TERRAIN_NONE);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i handle = _mm256_loadu_si256((const __m256i *) (handles + i));
+        __m256i x = _mm256_i32gather_epi32(store->x, handle, 4);
+        __m256i y = _mm256_i32gather_epi32(store->y, handle, 4);
+        const int *h = handles + i;
+        __m256i type = _mm256_setr_epi32(store->type[h[0]], store->type[h[1]], store->type[h[2]], store->type[h[3]],
+                                         store->type[h[4]], store->type[h[5]], store->type[h[6]], store->type[h[7]]);
+
+        // Só busca o terreno das unidades dentro do mapa; as demais ficam com TERRAIN_NONE.
+        // Cada terreno é um byte: a leitura de 32 bits cabe no TERRAIN_PADDING do mapa e o excesso é descartado.
+        __m256i inside = _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi32(x, minus_one), _mm256_cmpgt_epi32(max_x, x)),
+                                          _mm256_and_si256(_mm256_cmpgt_epi32(y, minus_one), _mm256_cmpgt_epi32(max_y, y)));
+        __m256i cell = _mm256_add_epi32(_mm256_mullo_epi32(x, max_y), y);
+        __m256i ground = _mm256_mask_i32gather_epi32(no_terrain, (const int *) terrain->cells, cell, inside, 1);
+        ground = _mm256_and_si256(ground, byte);
+
+        // Tipos desconhecidos viram 0, em vez de se confundirem com um tipo válido
+        type = _mm256_min_epu32(type, type_limit);
+        type = _mm256_and_si256(type, _mm256_cmpgt_epi32(type_limit, type));
+
+        __m256i slot = _mm256_or_si256(_mm256_slli_epi32(type, 2), _mm256_and_si256(ground, three));
+        __m256i yield = _mm256_i32gather_epi32(collect_yields, slot, 4);
+
+        int lane[8];
+        _mm256_storeu_si256((__m256i *) lane, yield);
+        if (yields != NULL) memcpy(yields + i, lane, sizeof(lane));
+        if (totals != NULL) add_totals(store, handles + i, lane, 8, totals, faction_count);
+    }
+    return i;
+}
+#endif
+
+/**
+ * @brief Calcula a coleta de recursos de um lote de unidades.
+ *
+ * O rendimento de cada unidade depende do seu tipo e do terreno na sua posição:
+ * soldados coletam 30, 20 ou 10 e exploradores 50, 40 ou 30, conforme o terreno seja
+ * PLANICE, FLORESTA ou MONTANHA. Unidades fora do mapa não coletam nada.
+ *
+ * @param store O armazenamento em arrays das unidades.
+ * @param handles Os handles das unidades que coletam. Devem ser de unidades vivas.
+ * @param count A quantidade de handles.
+ * @param terrain O mapa de terrenos. A posição (x, y) de uma unidade é a linha e a coluna no mapa.
+ * @param yields Se não for NULL, recebe o rendimento de cada unidade, na ordem de `handles`.
+ * @param totals Se não for NULL, cada rendimento é somado em `totals[faction_id]` da unidade.
+ * @param faction_count A quantidade de posições em `totals`; unidades de outras facções não são somadas.
+ */
+void collect_units(const unit_store_t *store, const int *handles, int count, const terrain_t *terrain,
+                   int *yields, int *totals, int faction_count) {
+    int done = 0;
+#ifdef COLLECT_HAS_AVX2
+    // As posições das células são calculadas em 32 bits no gather; mapas maiores usam a versão escalar
+    int fits = (size_t) terrain->lines * (size_t) terrain->columns * sizeof(*terrain->cells) <= INT_MAX;
+    if (count >= 8 && fits && __builtin_cpu_supports("avx2")) {
+        done = collect_units_avx2(store, handles, count, terrain, yields, totals, faction_count);
+    }
+#endif
+    collect_units_scalar(store, handles + done, count - done, terrain,
+                         yields != NULL ? yields + done : NULL, totals, faction_count);
+}
@@ -0,0 +1,400 @@
+/**
+ * @file engine.c
+ * @brief Interface da biblioteca do jogo (libgame), para executar partidas dentro de outro programa.
+ *
+ * Um servidor de partidas pode criar uma partida com `game_create`, aplicar comandos já
+ * decodificados (`command_t`) um a um ou em lotes, consultar o estado das facções e das
+ * unidades e encerrar a partida com `game_destroy`, sem criar processos nem analisar
+ * texto. A partida criada aqui é dona do seu log e do seu mapa de terrenos, que é
+ * compartilhado com as cópias feitas por `game_fork` e liberado pela última delas.
+ *
+ * Os objetos de uma partida vêm dos pools da thread atual (veja pool.c), que não são
+ * compartilhados entre threads. Por isso, uma partida pertence à thread que a criou:
+ * ela, e as cópias feitas a partir dela com `game_fork`, devem ser usadas e destruídas
+ * somente nessa thread. Threads diferentes podem executar partidas diferentes ao mesmo
+ * tempo, cada uma com as suas. Depois de destruir todas as suas partidas, uma thread
+ * pode devolver a memória dos seus pools com `release_pools`.
+ */
+
+#include "engine.h"
+
+#include <stdatomic.h>
+
+/*
+ * Terreno de uma partida e das suas cópias (`game_fork`), liberado pela última delas.
+ */
+typedef struct shared_terrain_t {
+    terrain_t *terrain;
+    atomic_int references;
+} shared_terrain_t;
+
+typedef struct engine_game_t {
+    game_t game;                        // Primeiro campo: o `game_t *` devolvido aponta para a estrutura inteira
+    shared_terrain_t *terrain;
+    log_t log;
+} engine_game_t;
+
+/**
+ * @brief Solta uma referência ao terreno compartilhado, liberando-o na última.
+ */
+static void release_terrain(shared_terrain_t *shared) {
+    if (atomic_fetch_sub(&shared->references, 1) != 1) return;
+    free_terrain(shared->terrain);
+    free(shared);
+}
+
+/**
+ * @brief Copia os dados públicos de uma facção.
+ */
+static void copy_faction_info(const faction_t *faction, game_faction_info_t *info) {
+    memcpy(info->name, faction->name, COMMAND_NAME_LEN);
+    info->id = faction->id;
+    info->resources = faction->resources;
+    info->power = faction->power;
+}
+
+/**
+ * @brief Aloca uma partida da biblioteca, com o terreno gerado a partir da semente e o log aberto.
+ *
+ * @param config A configuração da partida.
+ * @param rng O gerador, já semeado; recebe o estado seguinte à geração do terreno.
+ * @return A partida, ainda não iniciada, ou NULL se as dimensões forem inválidas, o log
+ *         não puder ser aberto ou a memória não puder ser alocada.
+ */
+static engine_game_t *open_engine(const game_config_t *config, rng_t *rng) {
+    engine_game_t *engine = (engine_game_t *) malloc(sizeof(engine_game_t));
+    if (engine == NULL) return NULL;
+
+    engine->terrain = (shared_terrain_t *) malloc(sizeof(shared_terrain_t));
+    terrain_t *terrain = create_terrain(config->rows, config->columns);
+    if (engine->terrain == NULL || terrain == NULL) {
+        free_terrain(terrain);
+        free(engine->terrain);
+        free(engine);
+        return NULL;
+    }
+    generate_terrain(terrain, next_rng(rng), config->threads);
+    engine->terrain->terrain = terrain;
+    atomic_init(&engine->terrain->references, 1);
+
+    if (open_log(&engine->log, config->log_path, config->log_categories, 0) != 0) {
+        release_terrain(engine->terrain);
+        free(engine);
+        return NULL;
+    }
+    return engine;
+}
+
+/**
+ * @brief Libera uma partida alocada com `open_engine` que não chegou a ser iniciada.
+ */
+static void close_engine(engine_game_t *engine) {
+    close_log(&engine->log);
+    release_terrain(engine->terrain);
+    free(engine);
+}
+
+/**
+ * @brief Cria uma partida vazia, com o terreno gerado a partir da semente.
+ *
+ * O terreno e a partida usam a mesma sequência da partida executada por `read_all_file`
+ * com a mesma semente.
+ *
+ * @param config A configuração da partida.
+ * @return A partida, ou NULL se as dimensões forem inválidas, o log não puder ser aberto
+ *         ou a memória não puder ser alocada.
+ */
+game_t *game_create(const game_config_t *config) {
+    rng_t rng;
+    seed_rng(&rng, config->seed);
+
+    engine_game_t *engine = open_engine(config, &rng);
+    if (engine == NULL) return NULL;
+
+    if (start_game(&engine->game, config->rows, config->columns, config->num_factions, &rng, engine->terrain->terrain, &engine->log) != 0) {
+        close_engine(engine);
+        return NULL;
+    }
+    set_board_keyframes(engine->game.board, config->keyframe_interval);
+    return &engine->game;
+}
+
+/**
+ * @brief Restaura uma partida gravada com `game_save`.
+ *
+ * O terreno é gerado de novo a partir de `config`, que deve ter as mesmas dimensões e a
+ * mesma semente da partida gravada. O número de facções e o intervalo entre quadros-chave
+ * vêm do snapshot; os de `config` são ignorados.
+ *
+ * @param config A configuração da partida.
+ * @param path O arquivo do snapshot.
+ * @return A partida, ou NULL se o arquivo não puder ser lido, não for um snapshot válido
+ *         para este terreno, o log não puder ser aberto ou a memória não puder ser alocada.
+ */
+game_t *game_load(const game_config_t *config, const char *path) {
+    rng_t rng;
+    seed_rng(&rng, config->seed);
+
+    engine_game_t *engine = open_engine(config, &rng);
+    if (engine == NULL) return NULL;
+
+    if (load_game(&engine->game, path, engine->terrain->terrain, &engine->log) != 0) {
+        close_engine(engine);
+        return NULL;
+    }
+    return &engine->game;
+}
+
+/**
+ * @brief Cria uma cópia independente da partida, para explorar jogadas alternativas.
+ *
+ * A cópia compartilha o terreno com a partida original (ele só é liberado quando a
+ * última das duas for destruída) e copia o resto do estado (veja `fork_game`). As duas
+ * podem ser destruídas em qualquer ordem, mas somente na thread que criou a original.
+ *
+ * @param game A partida copiada, criada com `game_create`, `game_load` ou `game_fork`.
+ * @param log_path Arquivo de log da cópia, ou NULL para descartar o log. As categorias
+ *                 registradas são as da partida original.
+ * @return A cópia, ou NULL se o log não puder ser aberto ou a memória não puder ser alocada.
+ */
+game_t *game_fork(const game_t *game, const char *log_path) {
+    const engine_game_t *parent = (const engine_game_t *) game;
+    engine_game_t *engine = (engine_game_t *) malloc(sizeof(engine_game_t));
+    if (engine == NULL) return NULL;
+
+    if (open_log(&engine->log, log_path, parent->log.categories, 0) != 0) {
+        free(engine);
+        return NULL;
+    }
+    if (fork_game(&engine->game, &parent->game, &engine->log) != 0) {
+        close_log(&engine->log);
+        free(engine);
+        return NULL;
+    }
+    engine->terrain = parent->terrain;
+    atomic_fetch_add(&engine->terrain->references, 1);
+    return &engine->game;
+}
+
+/**
+ * @brief Grava o estado da partida em um arquivo, para ser restaurado com `game_load`.
+ *
+ * @param game A partida.
+ * @param path O arquivo de destino.
+ * @return Retorna 0 em caso de sucesso, ou 1 se o arquivo não puder ser escrito.
+ */
+int game_save(const game_t *game, const char *path) {
+    return save_game(game, path);
+}
+
+/**
+ * @brief Aplica um comando à partida.
+ *
+ * @param game A partida, criada com `game_create`.
+ * @param command O comando. A ação é um `action_e`; os campos seguem o formato de `read_command`.
+ *                Nomes que não correspondem a facções ou unidades da partida são registrados
+ *                no log e não mudam nada; nomes longos são truncados em COMMAND_NAME_LEN - 1.
+ * @return Retorna 0 se a ação foi reconhecida, ou 1 se ela for desconhecida (o turno conta, mas nada muda).
+ */
+int game_apply_command(game_t *game, const command_t *command) {
+    apply_command(game, command);
+    return command->action == ACTION_UNKNOWN;
+}
+
+/**
+ * @brief Aplica uma sequência de comandos à partida, em ordem.
+ *
+ * @param game A partida, criada com `game_create`.
+ * @param commands Os comandos.
+ * @param count A quantidade de comandos.
+ * @return A quantidade de comandos com ação desconhecida.
+ */
+int game_step_batch(game_t *game, const command_t *commands, size_t count) {
+    int unknown = 0;
+    for (size_t i = 0; i < count; i++) {
+        apply_command(game, &commands[i]);
+        if (commands[i].action == ACTION_UNKNOWN) unknown++;
+    }
+    return unknown;
+}
+
+/**
+ * @brief Consulta uma facção pelo nome.
+ *
+ * @param game A partida.
+ * @param name O nome da facção.
+ * @param info Onde os dados da facção serão copiados.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a facção não existir.
+ */
+int game_query_faction(const game_t *game, const char *name, game_faction_info_t *info) {
+    const faction_t *faction = get_index(&game->faction_index, name);
+    if (faction == NULL) return 1;
+    copy_faction_info(faction, info);
+    return 0;
+}
+
+/**
+ * @brief Consulta todas as facções, na ordem da lista da partida.
+ *
+ * @param game A partida.
+ * @param infos Onde os dados das facções serão copiados.
+ * @param capacity Quantas facções cabem em `infos`.
+ * @return O número total de facções, que pode ser maior que `capacity`.
+ */
+int game_query_factions(const game_t *game, game_faction_info_t *infos, int capacity) {
+    int count = 0;
+    for (const faction_t *faction = game->factions; faction != NULL; faction = faction->next) {
+        if (count < capacity) copy_faction_info(faction, &infos[count]);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Copia os dados públicos de uma unidade.
+ */
+static void copy_unit_info(const game_t *game, const unit_t *unit, game_unit_info_t *info) {
+    memcpy(info->name, unit->name, COMMAND_NAME_LEN);
+    info->x = unit->x;
+    info->y = unit->y;
+    info->type = unit->type;
+    info->faction_id = unit->handle != UNIT_NO_HANDLE ? game->unit_store.faction_id[unit->handle] : -1;
+}
+
+/**
+ * @brief Consulta uma unidade pelo nome.
+ *
+ * @param game A partida.
+ * @param name O nome da unidade.
+ * @param info Onde os dados da unidade serão copiados.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a unidade não existir.
+ */
+int game_query_unit(const game_t *game, const char *name, game_unit_info_t *info) {
+    const unit_t *unit = get_index(&game->unit_index, name);
+    if (unit == NULL) return 1;
+    copy_unit_info(game, unit, info);
+    return 0;
+}
+
+/**
+ * @brief Consulta uma unidade pelo handle devolvido por `game_query_nearby`.
+ *
+ * @param game A partida.
+ * @param handle O handle da unidade.
+ * @param info Onde os dados da unidade serão copiados.
+ * @return Retorna 0 em caso de sucesso, ou 1 se o handle não pertencer a uma unidade viva.
+ */
+int game_query_handle(const game_t *game, int handle, game_unit_info_t *info) {
+    if (handle < 0 || handle >= game->unit_store.count || !game->unit_store.alive[handle]) return 1;
+    copy_unit_info(game, game->unit_store.units[handle], info);
+    return 0;
+}
+
+/**
+ * @brief Lista as unidades a no máximo `radius` células de uma posição, pelo índice espacial.
+ *
+ * @param game A partida.
+ * @param line A linha do centro.
+ * @param col A coluna do centro.
+ * @param radius O raio, em células (distância euclidiana).
+ * @param handles Onde os handles das unidades serão escritos (veja `game_query_handle`).
+ * @param capacity Quantos handles cabem em `handles`.
+ * @return O número de unidades no raio, que pode ser maior que `capacity`.
+ */
+int game_query_nearby(const game_t *game, int line, int col, int radius, int *handles, int capacity) {
+    return query_radius_spatial(&game->spatial, &game->unit_store, line, col, radius, handles, capacity);
+}
+
+/**
+ * @brief Encontra a unidade inimiga mais próxima de uma unidade (veja `nearest_enemy`).
+ *
+ * @param game A partida.
+ * @param name O nome da unidade.
+ * @return O handle da unidade inimiga mais próxima, ou -1 se a unidade não existir ou
+ *         não houver inimigos no tabuleiro.
+ */
+int game_query_nearest_enemy(const game_t *game, const char *name) {
+    const unit_t *unit = get_index(&game->unit_index, name);
+    if (unit == NULL) return UNIT_NO_HANDLE;
+    return nearest_enemy(game, unit->handle);
+}
+
+/**
+ * @brief Consulta a facção que venceria se a partida terminasse agora.
+ *
+ * @param game A partida.
+ * @param info Onde os dados da facção vencedora serão copiados.
+ * @return Retorna 0 em caso de sucesso, ou 1 se não houver facções.
+ */
+int game_query_winner(const game_t *game, game_faction_info_t *info) {
+    const faction_t *winner = find_winner(game);
+    if (winner == NULL) return 1;
+    copy_faction_info(winner, info);
+    return 0;
+}
+
+/**
+ * @brief Escolhe a próxima ação de uma facção com a IA de busca (veja ai.c).
+ *
+ * O comando escolhido não é aplicado: o chamador o aplica com `game_apply_command`, o
+ * que permite, por exemplo, partidas entre IAs ou entre uma IA e um jogador.
+ *
+ * @param game A partida. Não deve ser usada por outra thread durante a busca.
+ * @param faction O nome da facção que vai agir.
+ * @param config A configuração da busca, ou NULL para a padrão (veja `init_ai_config`).
+ * @param command Recebe o comando escolhido.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a facção não existir, não tiver nenhuma
+ *         ação possível ou a memória não puder ser alocada.
+ */
+int game_choose_action(const game_t *game, const char *faction, const ai_config_t *config, command_t *command) {
+    ai_config_t defaults;
+    if (config == NULL) {
+        init_ai_config(&defaults);
+        config = &defaults;
+    }
+    return choose_action(game, faction, config, command, NULL);
+}
+
+/**
+ * @brief Faz várias unidades caminharem até a mesma posição, com um único campo de fluxo.
+ *
+ * @param game A partida.
+ * @param names Os nomes das unidades. Nomes que não correspondem a unidades são ignorados.
+ * @param count A quantidade de nomes.
+ * @param line A linha do alvo.
+ * @param col A coluna do alvo.
+ * @param budget O custo máximo da caminhada de cada unidade, ou um valor negativo para ir até o alvo.
+ * @return Retorna 0 em caso de sucesso, ou 1 se o alvo estiver fora do tabuleiro ou a
+ *         memória não puder ser alocada.
+ */
+int game_walk_units(game_t *game, const char *const *names, int count, int line, int col, int budget) {
+    int status = 0;
+    // Os handles são resolvidos em blocos, para não alocar memória a cada chamada
+    for (int first = 0; first < count && status == 0; first += 64) {
+        int handles[64];
+        int chunk = count - first < 64 ? count - first : 64;
+        for (int i = 0; i < chunk; i++) {
+            const unit_t *unit = get_index(&game->unit_index, names[first + i]);
+            handles[i] = unit != NULL ? unit->handle : UNIT_NO_HANDLE;
+        }
+        status = walk_units(game, handles, chunk, line, col, budget);
+    }
+    return status;
+}
+
+/**
+ * @brief Encerra a partida, fechando o seu log e liberando o seu terreno.
+ *
+ * O resultado não é registrado no log; para isso, chame `finish_game` antes.
+ *
+ * @param game A partida, criada com `game_create`. Se for NULL, nada acontece.
+ */
+void game_destroy(game_t *game) {
+    if (game == NULL) return;
+    engine_game_t *engine = (engine_game_t *) game;
+
+    end_game(&engine->game);
+    close_log(&engine->log);
+    release_terrain(engine->terrain);
+    free(engine);
+}
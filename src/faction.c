@@ -6,7 +6,7 @@
 #include "faction.h"
 
 /**
- * @brief Aloca memória para uma nova facção e inicializa seus atributos.
+ * @brief Aloca uma nova facção do pool de facções e inicializa seus atributos.
  * 
  * @param name O nome da facção.
  * @param resources Os recursos da facção.
@@ -15,14 +15,16 @@
  */
 faction_t *allocate_faction(char name[15], int resources, int power){                 //Esta função aloca memória para uma nova instância de uma aliança, inicializa seu nome e a insere na lista ligada.
     faction_t *new_faction = NULL;
-    new_faction = (faction_t *) malloc(sizeof(faction_t));
+    new_faction = pool_alloc(POOL_FACTION, sizeof(faction_t));
     if(new_faction == NULL) return NULL;
     strcpy(new_faction->name, name);
+    new_faction->id = 0;
     new_faction->resources = resources;
     new_faction->power = power;
     new_faction->next = NULL;
     new_faction->units = NULL;
     new_faction->buildings = NULL;
+    new_faction->alliance = NULL;
     return new_faction;
 }
 
@@ -71,7 +73,7 @@ faction_t *get_faction(faction_t **factions, char name[2]){
  * @brief Libera a memória alocada para todos os nós de uma lista encadeada de facções.
  *
  * A função `free_factions` percorre a lista encadeada de facções (`faction_t`) apontada
- * por `*factions` e libera a memória alocada para cada nó. Após a liberação de cada nó,
+ * por `*factions` e devolve cada nó ao pool de facções. Após a liberação de cada nó,
  * o ponteiro do início da lista (`*factions`) é atualizado para apontar para o próximo nó.
  * Quando todos os nós são liberados, o ponteiro é definido como NULL.
  *
@@ -81,6 +83,6 @@ void free_factions(faction_t **factions){
     while(*factions != NULL){
         faction_t *temp = *factions;    // Armazena o nó atual em `temp`
         *factions = (*factions)->next;  // Atualiza `*factions` para apontar para o próximo nó
-        free(temp);                     // Libera a memória alocada para o nó atual
+        pool_free(POOL_FACTION, temp);  // Devolve o nó atual ao pool de facções
     }
 }
\ No newline at end of file
@@ -0,0 +1,326 @@
+/**
+ * @file game.c
+ * @brief Estado de uma partida e aplicação dos comandos sobre ele.
+ *
+ * Todo o estado de uma partida (tabuleiro, listas, índices, terreno, histórico de
+ * ataques, gerador de números aleatórios e log) fica em um `game_t`, que é passado a
+ * todos os manipuladores. Não há estado global: partidas diferentes podem ser
+ * executadas ao mesmo tempo em threads diferentes, sem travas. `read_all_file` cria uma partida e aplica os
+ * comandos à medida que os lê; o executor de Monte Carlo cria uma partida por
+ * simulação e aplica a mesma lista de comandos em cada uma.
+ */
+
+#include "game.h"
+#include "handlers.h"
+#include "profile.h"
+
+#define NEAREST_LOCAL_FACTIONS 256     // Facções marcadas na pilha por `nearest_enemy`
+
+/**
+ * @brief Inicia uma partida vazia.
+ *
+ * @param game A partida a ser iniciada.
+ * @param rows O número de linhas do tabuleiro.
+ * @param columns O número de colunas do tabuleiro.
+ * @param num_factions Quantos comandos `pos` iniciais posicionam facções (os seguintes posicionam unidades).
+ * @param rng O gerador da partida, já inicializado. É copiado para a partida.
+ * @param terrain O mapa de terrenos, com as mesmas dimensões do tabuleiro. Não é copiado
+ *                nem liberado pela partida e pode ser compartilhado entre partidas.
+ * @param log O log onde a partida será registrada.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se o tabuleiro não puder ser criado.
+ */
+int start_game(game_t *game, int rows, int columns, int num_factions, const rng_t *rng, const terrain_t *terrain, log_t *log) {
+    game->board = create_board(rows, columns);
+    if (game->board == NULL) return 1;
+    if (init_spatial(&game->spatial, rows, columns) != 0) {
+        free_board(game->board);
+        free(game->board);
+        return 1;
+    }
+
+    game->terrain = terrain;
+    game->factions = NULL;
+    game->buildings = NULL;
+    game->units = NULL;
+    init_index(&game->faction_index);
+    init_index(&game->unit_index);
+    init_unit_store(&game->unit_store);
+    init_pathfinder(&game->pathfinder, rows, columns);
+    game->rng = *rng;
+    game->log = log;
+    game->pending_factions = num_factions;
+    game->turns = 0;
+    game->last_part[0] = '\0';
+    memset(&game->history, 0, sizeof(history_t));
+    return 0;
+}
+
+/**
+ * @brief Aplica um comando à partida e registra o resumo do turno.
+ *
+ * Comandos com ação desconhecida ou com parâmetros faltando não alteram a partida,
+ * mas também contam como um turno.
+ *
+ * @param game A partida.
+ * @param command O comando a ser aplicado.
+ */
+void apply_command(game_t *game, const command_t *command) {
+    log_t *log = game->log;
+    char *part = game->last_part;
+    char name[COMMAND_NAME_LEN];
+    int params[COMMAND_MAX_PARAMS];
+
+    // Os manipuladores recebem cópias modificáveis dos campos do comando
+    memcpy(part, command->part, COMMAND_NAME_LEN);
+    memcpy(name, command->name, COMMAND_NAME_LEN);
+    // Comandos da biblioteca (veja engine.c) podem chegar com nomes sem terminador
+    part[COMMAND_NAME_LEN - 1] = '\0';
+    name[COMMAND_NAME_LEN - 1] = '\0';
+    memcpy(params, command->params, sizeof(params));
+    PROFILE_BEGIN(start);
+
+    // Verifica a ação e realiza o processamento correspondente
+    switch (command->action) {
+        case ACTION_ALLIANCE:
+            if (name[0] != '\0') {
+                handle_alliance(game, part, name);
+            }
+            break;
+        case ACTION_ATTACK:
+            if (name[0] != '\0') {
+                handle_attack(game, part, name);
+            }
+            break;
+        case ACTION_COMBAT:
+            // Sem o nome do inimigo, a unidade ataca o inimigo mais próximo
+            if (command->param_count >= 2) {
+                handle_combat(game, part, name);
+            }
+            break;
+        case ACTION_EARN:
+            if (command->param_count >= 1) {
+                handle_earn(game, part, params[0]);
+            }
+            break;
+        case ACTION_LOSE:
+            // Operação de perda (não implementada)
+            break;
+        case ACTION_WIN:
+            // Operação de vitória (não implementada)
+            break;
+        case ACTION_POSITION:
+            // As primeiras posições são das facções, as seguintes das unidades
+            if (game->pending_factions > 0) {
+                if (command->param_count >= 2) {
+                    handle_position_faction(game, part, params);
+                    game->pending_factions--;
+                }
+            } else if (command->param_count >= 3) {
+                handle_position_unit(game, part, params);
+            }
+            break;
+        case ACTION_MOVE:
+            if (command->param_count >= 3) {
+                handle_move(game, part, params);
+            }
+            break;
+        case ACTION_COLLECT:
+            if (command->param_count >= 2) {
+                handle_collect(game, part);
+            }
+            break;
+        case ACTION_BUILD:
+            if (command->param_count >= 4) {
+                handle_building(game, part, params);
+            }
+            break;
+        case ACTION_DEFEND:
+            if (command->param_count >= 2) {
+                handle_defend(game, part);
+            }
+            break;
+        case ACTION_WALK:
+            // O quarto parâmetro, se houver, limita o custo da caminhada
+            if (command->param_count >= 3) {
+                handle_walk(game, part, params, command->param_count >= 4 ? params[3] : -1);
+            }
+            break;
+        case ACTION_UNKNOWN:
+            break;
+    }
+    PROFILE_END(command->action, start);
+    game->turns++;
+
+    // Resumo do turno: mensagens fixas e inteiros formatados direto no buffer do log
+    if (LOG_ENABLED(log, LOG_TURNS)) {
+        LOG_FIXED(log, LOG_TURNS, "=== Fim do turno ===\n");
+        faction_t *temp = game->factions;
+        while(temp != NULL){
+            print_log(log, LOG_TURNS, "Turno do jogador %s finalizado.\nRecursos atualizados: %d.\nPoder atualizado: %d.\n\n",
+                      temp->name, temp->resources, temp->power);
+            temp = temp->next;
+        }
+    }
+}
+
+/**
+ * @brief Faz várias unidades caminharem até a mesma posição.
+ *
+ * Em vez de uma busca A* por unidade, calcula uma única vez o campo de fluxo do alvo
+ * (veja `build_flow_field`), reaproveitado enquanto o alvo for o mesmo, e cada unidade
+ * apenas desce o campo. Cada unidade anda até o alvo ou até gastar `budget`.
+ *
+ * @param game A partida.
+ * @param handles Os handles (`unit_store_t`) das unidades. Handles livres são ignorados.
+ * @param count A quantidade de handles.
+ * @param line A linha do alvo.
+ * @param col A coluna do alvo.
+ * @param budget O custo máximo da caminhada de cada unidade, ou um valor negativo para ir até o alvo.
+ * @return Retorna 0 em caso de sucesso, ou 1 se o alvo estiver fora do tabuleiro ou a
+ *         memória não puder ser alocada.
+ */
+int walk_units(game_t *game, const int *handles, int count, int line, int col, int budget) {
+    if (build_flow_field(&game->pathfinder, game->terrain, line, col) != 0) return 1;
+
+    for (int i = 0; i < count; i++) {
+        int handle = handles[i];
+        if (handle < 0 || handle >= game->unit_store.count || !game->unit_store.alive[handle]) continue;
+
+        unit_t *unit = game->unit_store.units[handle];
+        int to_line = unit->x, to_col = unit->y, steps;
+        int spent = follow_flow_field(&game->pathfinder, game->terrain, &to_line, &to_col, budget, &steps);
+        if (steps == 0) continue;
+
+        move_unit(game->board, unit, to_line, to_col);
+        move_unit_store(&game->unit_store, handle, to_line, to_col);
+        move_spatial(&game->spatial, handle, to_line, to_col);
+        print_log(game->log, LOG_EVENTS, "Unidade %s caminhou até (%d, %d) em %d passos, com custo %d.\n",
+                  unit->name, to_line, to_col, steps, spent);
+    }
+
+    print_board(game->log, game->board);
+    LOG_FIXED(game->log, LOG_EVENTS, "\n");
+    return 0;
+}
+
+/**
+ * @brief Encontra a unidade inimiga mais próxima de uma unidade, pelo índice espacial.
+ *
+ * São inimigas as unidades de facções que não são a da unidade nem aliadas a ela. Uma
+ * unidade sem facção não tem aliados: todas as outras unidades, inclusive as outras sem
+ * facção, são inimigas dela, e ela é inimiga de todas.
+ *
+ * @param game A partida.
+ * @param handle O handle da unidade de referência.
+ * @return O handle da unidade inimiga mais próxima, ou UNIT_NO_HANDLE se não houver
+ *         nenhuma ou a memória não puder ser alocada (só com mais de NEAREST_LOCAL_FACTIONS facções).
+ */
+int nearest_enemy(const game_t *game, int handle) {
+    if (handle == UNIT_NO_HANDLE) return UNIT_NO_HANDLE;
+
+    // Os ids das facções vão de 0 ao número de facções (veja `handle_position_faction`).
+    // A marcação fica na pilha; só partidas com muitas facções precisam alocar.
+    unsigned char local[NEAREST_LOCAL_FACTIONS];
+    int count = (int) game->faction_index.count;
+    unsigned char *friendly = local;
+    if (count > NEAREST_LOCAL_FACTIONS) {
+        friendly = (unsigned char *) malloc((size_t) count);
+        if (friendly == NULL) return UNIT_NO_HANDLE;
+    }
+    memset(friendly, 0, count > 0 ? (size_t) count : 0);
+
+    // A facção de uma unidade é "F" seguido da primeira letra do nome (veja `handle_position_unit`)
+    int faction_id = game->unit_store.faction_id[handle];
+    if (faction_id >= 0 && faction_id < count) {
+        friendly[faction_id] = 1;
+        const unit_t *unit = game->unit_store.units[handle];
+        char faction_name[3] = {'F', unit->name[0], '\0'};
+        const faction_t *faction = get_index(&game->faction_index, faction_name);
+        for (const alliance_t *alliance = faction != NULL && faction->id == faction_id ? faction->alliance : NULL;
+             alliance != NULL; alliance = alliance->next) {
+            const faction_t *ally = get_index(&game->faction_index, alliance->name);
+            if (ally != NULL && ally->id >= 0 && ally->id < count) friendly[ally->id] = 1;
+        }
+    }
+
+    int nearest = nearest_enemy_spatial(&game->spatial, &game->unit_store, handle, friendly, count);
+    if (friendly != local) free(friendly);
+    return nearest;
+}
+
+/**
+ * @brief Determina o vencedor da partida, sem registrar nada no log.
+ *
+ * Vence a facção com a maior soma de poder e recursos. Em caso de empate, vence a
+ * que aparece primeiro na lista de facções.
+ *
+ * @param game A partida.
+ * @return A facção vencedora, ou NULL se não houver facções.
+ */
+faction_t *find_winner(const game_t *game) {
+    faction_t *winner = NULL;
+    faction_t *current_faction = game->factions;
+
+    while (current_faction != NULL) {
+        // Verifica se ainda não há vencedor ou se a facção atual supera o vencedor atual
+        if (winner == NULL || current_faction->power + current_faction->resources > winner->power + winner->resources) {
+            winner = current_faction;
+        }
+        current_faction = current_faction->next;
+    }
+    return winner;
+}
+
+/**
+ * @brief Determina o vencedor da partida e registra o resultado no log.
+ *
+ * @param game A partida.
+ * @return A facção vencedora (veja `find_winner`), ou NULL se não houver facções.
+ */
+faction_t *finish_game(game_t *game) {
+    log_t *log = game->log;
+    faction_t *winner = find_winner(game);
+
+    if (winner != NULL) {
+        print_log(log, LOG_RESULT, "A facção vencedora é: %s\n", winner->name);
+        print_log(log, LOG_RESULT, "Poder: %d\n", winner->power);
+        print_log(log, LOG_RESULT, "Recursos: %d\n\n", winner->resources);
+    } else {
+        // Caso nenhuma facção tenha poder ou recursos positivos
+        LOG_FIXED(log, LOG_RESULT, "Nenhuma facção tem poder ou recursos positivos. Não há vencedor.\n\n");
+    }
+
+    LOG_FIXED(log, LOG_RESULT, "=== Vitória alcançada ===\n");
+    print_log(log, LOG_RESULT, "Facção %s alcançou a vitória!\n", game->last_part);
+    LOG_FIXED(log, LOG_RESULT, "Parabéns!\n\n");
+    return winner;
+}
+
+/**
+ * @brief Libera todo o estado da partida.
+ *
+ * Facções, alianças, prédios e unidades são devolvidos aos pools da thread atual, de
+ * modo que outras partidas da mesma thread continuam válidas. Os blocos dos pools só
+ * são liberados com `release_pools`, quando a thread não tiver mais partidas. O log e
+ * o mapa de terrenos não são liberados.
+ *
+ * @param game A partida a ser encerrada.
+ */
+void end_game(game_t *game) {
+    free_index(&game->faction_index);
+    free_index(&game->unit_index);
+    free_unit_store(&game->unit_store);
+    free_spatial(&game->spatial);
+    free_pathfinder(&game->pathfinder);
+    free_board(game->board);
+    free(game->board);
+    game->board = NULL;
+
+    for (faction_t *faction = game->factions; faction != NULL; faction = faction->next) {
+        free_alliances(&faction->alliance);
+    }
+    free_factions(&game->factions);
+    free_buildings(&game->buildings);
+    free_units(&game->units);
+}
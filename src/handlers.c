@@ -9,21 +9,6 @@
 
 #include "handlers.h"
 
-/**
- * @brief Estrutura de histórico para armazenar detalhes de ações no jogo.
- * 
- * Esta estrutura é utilizada para manter um registro das ações realizadas no jogo,
- * incluindo informações como as facções envolvidas em ataques, e a quantidade de
- * recursos roubados durante esses ataques.
- * 
- * A estrutura contém os seguintes campos:
- * - attacking_faction: Nome da facção que está realizando o ataque.
- * - defending_faction: Nome da facção que está sendo atacada.
- * - stolen_resources: Quantidade de recursos roubados durante o ataque.
- */
-
-history_t history = {"", "", 0};
-
 /**
  * @brief Estabelece uma aliança entre duas facções e atualiza seus poderes.
  * 
@@ -31,21 +16,29 @@ history_t history = {"", "", 0};
  * alianças da outra facção e atualiza o poder das facções conforme o poder da facção aliada é adicionado.
  * A função registra a aliança no log, junto com os novos valores de poder das facções envolvidas.
  * 
- * @param log Um ponteiro para um arquivo onde o log será escrito. Deve estar previamente aberto para escrita.
- * @param factions Um ponteiro para um ponteiro da lista de facções. A função assume que essa lista está corretamente inicializada.
+ * @param game A partida onde a ação é aplicada.
  * @param part O nome da primeira facção que está estabelecendo a aliança. Deve ser uma string válida correspondente a uma facção existente.
  * @param faction O nome da segunda facção que será aliada. Deve ser uma string válida correspondente a uma facção existente.
  * 
  * @pre O arquivo de log deve estar aberto para escrita.
- * @pre O ponteiro para a lista de facções (`factions`) deve apontar para uma lista inicializada e não ser nulo.
+ * @pre O índice de facções (`faction_index`) deve estar inicializado e não ser nulo.
  * @pre Os nomes das facções (`part` e `faction`) devem ser strings válidas que correspondem a facções existentes no jogo.
  * 
  * @post As facções `part` e `faction` estarão aliadas entre si, com seus poderes atualizados de acordo com a soma dos poderes.
  * @post A aliança entre as facções será registrada no log, incluindo os novos valores de poder das facções envolvidas.
  */
-void handle_alliance(FILE *log, faction_t **factions, char *part, char *faction) {
-    faction_t *faction0 = get_faction(factions, part);
-    faction_t *faction1 = get_faction(factions, faction);
+void handle_alliance(game_t *game, char *part, char *faction) {
+    log_t *log = game->log;
+    name_index_t *faction_index = &game->faction_index;
+
+    faction_t *faction0 = get_index(faction_index, part);
+    faction_t *faction1 = get_index(faction_index, faction);
+
+    if(faction0 == NULL || faction1 == NULL) {
+        LOG_FIXED(log, LOG_EVENTS, "Erro: Facção não encontrada.\n");
+        return;
+    }
+
     insert_alliance(&(faction0->alliance), faction);
     insert_alliance(&(faction1->alliance), part);
 
@@ -53,10 +46,10 @@ void handle_alliance(FILE *log, faction_t **factions, char *part, char *faction)
     faction0->power += faction1->power;
     faction1->power += temp0;
 
-    fprintf(log, "=== Aliança estabelecida ===\n");
-    fprintf(log, "Facção %s e Facção %s estão agora aliadas.\n", faction0->name, faction1->name);
-    fprintf(log, "%s agora possui %d de poder.\n", faction0->name, faction0->power);
-    fprintf(log, "%s agora possui %d de poder.\n\n", faction1->name, faction1->power);
+    LOG_FIXED(log, LOG_EVENTS, "=== Aliança estabelecida ===\n");
+    print_log(log, LOG_EVENTS, "Facção %s e Facção %s estão agora aliadas.\n", faction0->name, faction1->name);
+    print_log(log, LOG_EVENTS, "%s agora possui %d de poder.\n", faction0->name, faction0->power);
+    print_log(log, LOG_EVENTS, "%s agora possui %d de poder.\n\n", faction1->name, faction1->power);
 }
 
 /**
@@ -66,41 +59,44 @@ void handle_alliance(FILE *log, faction_t **factions, char *part, char *faction)
  * roubados durante o ataque, atualiza os recursos das facções envolvidas e registra as mudanças no log.
  * Além disso, mantém um histórico do ataque, armazenando as facções envolvidas e a quantidade de recursos roubados.
  * 
- * @param log Um ponteiro para um arquivo onde o log será escrito. Deve estar previamente aberto para escrita.
- * @param factions Um ponteiro para um ponteiro da lista de facções. A função assume que essa lista está corretamente inicializada.
+ * @param game A partida onde a ação é aplicada.
  * @param part O nome da facção que está realizando o ataque. Deve ser uma string válida.
  * @param param O nome da facção que está sendo atacada. Deve ser uma string válida.
  * 
  * @pre O arquivo de log deve estar aberto para escrita.
- * @pre O ponteiro para a lista de facções (`factions`) deve apontar para uma lista inicializada e não ser nulo.
+ * @pre O índice de facções (`faction_index`) deve estar inicializado e não ser nulo.
  * @pre Os nomes das facções (`part` e `param`) devem ser strings válidas que correspondem a facções existentes.
  * 
  * @post As facções envolvidas no ataque terão seus recursos atualizados de acordo com a quantidade roubada.
  * @post O histórico do ataque será atualizado com as facções envolvidas e a quantidade de recursos roubados.
  */
-void handle_attack(FILE *log, faction_t **factions, char *part, char *param) {
-    int random_resources = rand() % 50;
+void handle_attack(game_t *game, char *part, char *param) {
+    log_t *log = game->log;
+    name_index_t *faction_index = &game->faction_index;
+    history_t *history = &game->history;
+
+    int random_resources = range_rng(&game->rng, 50);
 
-    faction_t *attacking_faction = get_faction(&(*factions), part);
-    faction_t *defending_faction = get_faction(&(*factions), param);
+    faction_t *attacking_faction = get_index(faction_index, part);
+    faction_t *defending_faction = get_index(faction_index, param);
 
     if(attacking_faction == NULL || defending_faction == NULL) {
-        fprintf(log, "Erro: Facção não encontrada.\n");
+        LOG_FIXED(log, LOG_EVENTS, "Erro: Facção não encontrada.\n");
         return;
     }
 
-    strcpy(history.attacking_faction, part);
-    strcpy(history.defending_faction, param);
-    history.stolen_resources = random_resources;
+    snprintf(history->attacking_faction, sizeof(history->attacking_faction), "%s", part);
+    snprintf(history->defending_faction, sizeof(history->defending_faction), "%s", param);
+    history->stolen_resources = random_resources;
 
     attacking_faction->resources += random_resources;
     defending_faction->resources -= random_resources;
 
-    fprintf(log, "=== Ataque realizado ===\n");
-    fprintf(log, "Facção %s atacou Facção %s.\n", part, param);
-    fprintf(log, "Recursos roubados: %d.\n", random_resources);
-    fprintf(log, "%s agora possui %d recursos.\n", attacking_faction->name, attacking_faction->resources);
-    fprintf(log, "%s agora possui %d recursos.\n\n", defending_faction->name, defending_faction->resources);
+    LOG_FIXED(log, LOG_EVENTS, "=== Ataque realizado ===\n");
+    print_log(log, LOG_EVENTS, "Facção %s atacou Facção %s.\n", part, param);
+    print_log(log, LOG_EVENTS, "Recursos roubados: %d.\n", random_resources);
+    print_log(log, LOG_EVENTS, "%s agora possui %d recursos.\n", attacking_faction->name, attacking_faction->resources);
+    print_log(log, LOG_EVENTS, "%s agora possui %d recursos.\n\n", defending_faction->name, defending_faction->resources);
 }
 
 /**
@@ -109,11 +105,10 @@ void handle_attack(FILE *log, faction_t **factions, char *part, char *param) {
  * Esta função inicia um combate entre duas unidades, determina o resultado do combate com base em valores
  * de ataque aleatórios e atualiza o estado do tabuleiro e das unidades em consequência do resultado.
  * 
- * @param log Um ponteiro para um arquivo onde o log será escrito. Deve estar previamente aberto para escrita.
- * @param board Um ponteiro para o tabuleiro onde o combate ocorre. A função assume que o tabuleiro está corretamente inicializado.
- * @param units Um ponteiro para um ponteiro da lista de unidades. A função assume que essa lista está corretamente inicializada.
+ * @param game A partida onde a ação é aplicada.
  * @param part O nome da unidade que está iniciando o combate. Deve ser uma string válida correspondente a uma unidade existente.
- * @param enemy_name O nome da unidade inimiga. Deve ser uma string válida correspondente a uma unidade existente.
+ * @param enemy_name O nome da unidade inimiga. Se for vazio, a unidade ataca a unidade inimiga
+ *                   mais próxima (veja `nearest_enemy`), encontrada pelo índice espacial da partida.
  * @param self_value Um valor representando algum atributo ou condição da unidade que está iniciando o combate (não usado diretamente na lógica atual).
  * @param enemy_value Um valor representando algum atributo ou condição da unidade inimiga (não usado diretamente na lógica atual).
  * 
@@ -131,91 +126,74 @@ void handle_attack(FILE *log, faction_t **factions, char *part, char *param) {
  * 
  * O estado do tabuleiro é atualizado após o combate, e o resultado é registrado no arquivo de log.
  * 
- * @param log O arquivo de log onde os detalhes do combate serão registrados.
- * @param board O tabuleiro onde o combate ocorre.
- * @param units A lista de unidades presentes no jogo.
  * @param part O nome da unidade que está iniciando o combate.
  * @param enemy_name O nome da unidade inimiga.
  * @param self_value Um valor representando um atributo ou condição da unidade atacante.
  * @param enemy_value Um valor representando um atributo ou condição da unidade inimiga.
  * 
  */
-void handle_combat(FILE *log, board_t *board, unit_t **units, char *part, char *enemy_name) {
-    fprintf(log, "=== Combate iniciado ===\n");
-    fprintf(log, "Unidade %s atacando unidade %s\n", part, enemy_name);
+void handle_combat(game_t *game, char *part, char *enemy_name) {
+    log_t *log = game->log;
+    board_t *board = game->board;
+    name_index_t *unit_index = &game->unit_index;
+    char nearest_name[COMMAND_NAME_LEN];
+
+    // Sem alvo, a unidade ataca a unidade inimiga mais próxima (veja spatial.c)
+    if(enemy_name[0] == '\0') {
+        unit_t *unit = get_index(unit_index, part);
+        int nearest = unit != NULL ? nearest_enemy(game, unit->handle) : UNIT_NO_HANDLE;
+        if(nearest == UNIT_NO_HANDLE) {
+            LOG_FIXED(log, LOG_EVENTS, "=== Combate iniciado ===\n");
+            print_log(log, LOG_EVENTS, unit != NULL ? "Nenhuma unidade inimiga para %s.\n" : "Unidade %s não encontrada.\n", part);
+            return;
+        }
+        memcpy(nearest_name, game->unit_store.units[nearest]->name, COMMAND_NAME_LEN);
+        enemy_name = nearest_name;
+    }
+
+    LOG_FIXED(log, LOG_EVENTS, "=== Combate iniciado ===\n");
+    print_log(log, LOG_EVENTS, "Unidade %s atacando unidade %s\n", part, enemy_name);
 
-    unit_t *self_unit = get_unit(units, part);
-    unit_t *enemy_unit = get_unit(units, enemy_name);
+    unit_t *self_unit = get_index(unit_index, part);
+    unit_t *enemy_unit = get_index(unit_index, enemy_name);
 
     if(self_unit == NULL) {
-        fprintf(log, "Unidade não encontrada.\n");
+        LOG_FIXED(log, LOG_EVENTS, "Unidade não encontrada.\n");
         return;
     }
 
     if(enemy_unit == NULL) {
-        fprintf(log, "Unidade inimiga não encontrada.\n");
+        LOG_FIXED(log, LOG_EVENTS, "Unidade inimiga não encontrada.\n");
         return;
     }
 
     // Cria dois valores aleatórios para o potencial de ataque de cada unidade
-    int self_attack = self_unit->type == SOLDIER ? rand() % 10 : rand() % 6;
-    int enemy_attack = enemy_unit->type == SOLDIER ? rand() % 10 : rand() % 6;
+    int self_attack = range_rng(&game->rng, self_unit->type == SOLDIER ? 10 : 6);
+    int enemy_attack = range_rng(&game->rng, enemy_unit->type == SOLDIER ? 10 : 6);
 
     // Imprime os valores de ataque
-    fprintf(log, "Potencial de ataque de %s: %d\n", part, self_attack);
-    fprintf(log, "Potencial de ataque de %s: %d\n", enemy_name, enemy_attack);
-    fprintf(log, "Resultado: ");
+    print_log(log, LOG_EVENTS, "Potencial de ataque de %s: %d\n", part, self_attack);
+    print_log(log, LOG_EVENTS, "Potencial de ataque de %s: %d\n", enemy_name, enemy_attack);
+    LOG_FIXED(log, LOG_EVENTS, "Resultado: ");
 
+    // A unidade derrotada sai do tabuleiro, do índice e da lista de unidades
+    unit_t *loser = NULL;
     if(self_attack > enemy_attack) {
-        unit_t *unit = get_unit(units, enemy_name);
-        faction_t *faction_on = get_faction_board(board, unit->x, unit->y);
-        building_t *building_on = get_building_board(board, unit->x, unit->y);
-        unit_t *unit_on = get_unit_board(board, unit->x, unit->y);
-        unit_t *unit1_on = get_unit1_board(board, unit->x, unit->y);
-        unit_t *unit2_on = get_unit2_board(board, unit->x, unit->y);
-
-        remove_node(board, unit->x, unit->y);
-        insert_node(board, unit->x, unit->y, NULL, building_on, faction_on);
-        if(strcmp(unit->name, unit_on->name) == 0){
-            insert_node(board, unit->x, unit->y, unit1_on, NULL, NULL);
-            insert_node(board, unit->x, unit->y, unit2_on, NULL, NULL);
-        }
-        else if(strcmp(unit->name, unit1_on->name) == 0){
-            insert_node(board, unit->x, unit->y, unit_on, NULL, NULL);
-            insert_node(board, unit->x, unit->y, unit2_on, NULL, NULL);
-        }
-        else if(strcmp(unit->name, unit2_on->name) == 0){
-            insert_node(board, unit->x, unit->y, unit_on, NULL, NULL);
-            insert_node(board, unit->x, unit->y, unit1_on, NULL, NULL);
-        }
-        remove_unit(units, unit->x, unit->y);
-        fprintf(log, "Unidade %s venceu o combate.\n", part);
+        loser = enemy_unit;
+        print_log(log, LOG_EVENTS, "Unidade %s venceu o combate.\n", part);
     } else if(self_attack < enemy_attack) {
-        unit_t *unit = get_unit(units, part);
-        faction_t *faction_on = get_faction_board(board, unit->x, unit->y);
-        building_t *building_on = get_building_board(board, unit->x, unit->y);
-        unit_t *unit_on = get_unit_board(board, unit->x, unit->y);
-        unit_t *unit1_on = get_unit1_board(board, unit->x, unit->y);
-        unit_t *unit2_on = get_unit2_board(board, unit->x, unit->y);
-
-        remove_node(board, unit->x, unit->y);
-        insert_node(board, unit->x, unit->y, NULL, building_on, faction_on);
-        if(strcmp(unit->name, unit_on->name) == 0){
-            insert_node(board, unit->x, unit->y, unit1_on, NULL, NULL);
-            insert_node(board, unit->x, unit->y, unit2_on, NULL, NULL);
-        }
-        else if(strcmp(unit->name, unit1_on->name) == 0){
-            insert_node(board, unit->x, unit->y, unit_on, NULL, NULL);
-            insert_node(board, unit->x, unit->y, unit2_on, NULL, NULL);
-        }
-        else if(strcmp(unit->name, unit2_on->name) == 0){
-            insert_node(board, unit->x, unit->y, unit_on, NULL, NULL);
-            insert_node(board, unit->x, unit->y, unit1_on, NULL, NULL);
-        }
-        remove_unit(units, unit->x, unit->y);
-        fprintf(log, "Unidade %s perdeu o combate.\n", part);
+        loser = self_unit;
+        print_log(log, LOG_EVENTS, "Unidade %s perdeu o combate.\n", part);
     } else {
-        fprintf(log, "Combate entre %s e %s terminou em empate.\n", part, enemy_name);
+        print_log(log, LOG_EVENTS, "Combate entre %s e %s terminou em empate.\n", part, enemy_name);
+    }
+
+    if(loser != NULL) {
+        remove_unit_board(board, loser);
+        remove_index(unit_index, loser->name);
+        remove_spatial(&game->spatial, loser->handle);
+        remove_unit_store(&game->unit_store, loser->handle);
+        delete_unit(&game->units, loser);
     }
 
     print_board(log, board);
@@ -227,9 +205,7 @@ void handle_combat(FILE *log, board_t *board, unit_t **units, char *part, char *
  * Esta função insere uma nova facção no tabuleiro de jogo em uma posição especificada pelas coordenadas,
  * atualiza o estado do tabuleiro e registra as mudanças no log.
  * 
- * @param log Um ponteiro para um arquivo onde o log será escrito. Deve estar previamente aberto.
- * @param board Um ponteiro para um ponteiro do tabuleiro de jogo. A função assume que o tabuleiro está corretamente inicializado.
- * @param factions Um ponteiro para um ponteiro da lista de facções. A função assume que essa lista está corretamente inicializada.
+ * @param game A partida onde a ação é aplicada.
  * @param part O identificador da facção que está sendo posicionada. Deve ser uma string válida.
  * @param params Um array de inteiros contendo os parâmetros da posição da facção:
  *               - params[0]: Coordenada x onde a facção será posicionada.
@@ -237,20 +213,34 @@ void handle_combat(FILE *log, board_t *board, unit_t **units, char *part, char *
  * 
  * @pre O arquivo de log deve estar aberto para escrita.
  * @pre O ponteiro para o tabuleiro de jogo (`board`) deve apontar para um tabuleiro inicializado e não ser nulo.
- * @pre O ponteiro para a lista de facções (`factions`) deve apontar para uma lista inicializada e não ser nulo.
+ * @pre O índice de facções (`faction_index`) deve estar inicializado e não ser nulo.
  * @pre O identificador da facção (`part`) deve ser uma string válida.
  * @pre Os parâmetros (`params`) devem conter as coordenadas válidas para a posição da facção no tabuleiro.
  * 
- * @post A facção será inserida no tabuleiro na posição especificada.
+ * @post A facção será inserida no tabuleiro na posição especificada, a menos que já exista
+ *       uma facção com o mesmo nome; nesse caso, nada muda e o log registra a recusa.
  * @post O estado atualizado do tabuleiro será impresso no log.
  */
-void handle_position_faction(FILE *log, board_t **board, faction_t **factions, char *part, int *params) {
+void handle_position_faction(game_t *game, char *part, int *params) {
+    log_t *log = game->log;
+    faction_t **factions = &game->factions;
+    name_index_t *faction_index = &game->faction_index;
+
+    // O id é a posição da facção no índice: um nome repetido teria o id de outra facção
+    if (get_index(faction_index, part) != NULL) {
+        LOG_FIXED(log, LOG_EVENTS, "=== Inserir facção ===\n");
+        print_log(log, LOG_EVENTS, "Facção %s já existe.\n\n", part);
+        return;
+    }
+
     insert_faction(&(*factions), part, 100, 100);
-    insert_node(*board, params[0], params[1], NULL, NULL, *factions);
-    fprintf(log, "=== Inserir facção ===\n");
-    fprintf(log, "Facção %s inserida no tabuleiro em posição (%d, %d).\n", part, params[0], params[1]);
-    print_board(log, *board);
-    fprintf(log, "\n");
+    (*factions)->id = (int) faction_index->count;
+    insert_index(faction_index, (*factions)->name, *factions);
+    insert_node(game->board, params[0], params[1], NULL, NULL, *factions);
+    LOG_FIXED(log, LOG_EVENTS, "=== Inserir facção ===\n");
+    print_log(log, LOG_EVENTS, "Facção %s inserida no tabuleiro em posição (%d, %d).\n", part, params[0], params[1]);
+    print_board(log, game->board);
+    LOG_FIXED(log, LOG_EVENTS, "\n");
 }
 
 /**
@@ -260,10 +250,7 @@ void handle_position_faction(FILE *log, board_t **board, faction_t **factions, c
  * atualiza o estado do tabuleiro e registra as mudanças no log. Além disso, aumenta o poder da facção
  * correspondente à unidade e registra essa atualização no log.
  * 
- * @param log Um ponteiro para um arquivo onde o log será escrito. Deve estar previamente aberto.
- * @param board Um ponteiro para um ponteiro do tabuleiro de jogo. A função assume que o tabuleiro está corretamente inicializado.
- * @param factions Um ponteiro para um ponteiro da lista de facções. A função assume que essa lista está corretamente inicializada.
- * @param units Um ponteiro para um ponteiro da lista de unidades. A função assume que essa lista está corretamente inicializada.
+ * @param game A partida onde a ação é aplicada.
  * @param part O identificador da unidade que está sendo posicionada. Deve ser uma string válida.
  * @param params Um array de inteiros contendo os parâmetros da posição da unidade:
  *               - params[1]: Coordenada x onde a unidade será posicionada.
@@ -271,36 +258,51 @@ void handle_position_faction(FILE *log, board_t **board, faction_t **factions, c
  * 
  * @pre O arquivo de log deve estar aberto para escrita.
  * @pre O ponteiro para o tabuleiro de jogo (`board`) deve apontar para um tabuleiro inicializado e não ser nulo.
- * @pre O ponteiro para a lista de facções (`factions`) deve apontar para uma lista inicializada e não ser nulo.
+ * @pre O índice de facções (`faction_index`) deve estar inicializado e não ser nulo.
  * @pre O ponteiro para a lista de unidades (`units`) deve apontar para uma lista inicializada e não ser nulo.
  * @pre O identificador da unidade (`part`) deve ser uma string válida.
  * @pre Os parâmetros (`params`) devem conter as coordenadas válidas para a posição da unidade no tabuleiro.
  * 
- * @post A unidade será inserida no tabuleiro na posição especificada.
+ * @post A unidade será inserida no tabuleiro na posição especificada, a menos que já exista
+ *       uma unidade com o mesmo nome; nesse caso, nada muda e o log registra a recusa.
  * @post O poder da facção correspondente à unidade será aumentado em 10 unidades.
  * @post O estado atualizado do tabuleiro será impresso no log.
  */
-void handle_position_unit(FILE *log, board_t **board, faction_t **factions, unit_t **units, char *part, int *params) {
-    fprintf(log, "=== Inserir unidade ===\n");
+void handle_position_unit(game_t *game, char *part, int *params) {
+    log_t *log = game->log;
+    unit_t **units = &game->units;
+    name_index_t *unit_index = &game->unit_index;
+
+    LOG_FIXED(log, LOG_EVENTS, "=== Inserir unidade ===\n");
+
+    // O índice guarda uma unidade por nome: uma segunda unidade com o mesmo nome esconderia a primeira
+    if (get_index(unit_index, part) != NULL) {
+        print_log(log, LOG_EVENTS, "Unidade %s já existe.\n\n", part);
+        return;
+    }
+
+    // A facção de uma unidade é "F" seguido da primeira letra do nome da unidade
+    char faction_name[3] = {'F', part[0], '\0'};
+    faction_t *faction = get_index(&game->faction_index, faction_name);
 
     insert_unit(&(*units), params[1], params[2], part, params[0]);
-    insert_node(*board, params[1], params[2], *units, NULL, NULL);
+    insert_index(unit_index, (*units)->name, *units);
+    insert_unit_store(&game->unit_store, *units, faction != NULL ? faction->id : -1);
+    insert_spatial(&game->spatial, &game->unit_store, (*units)->handle);
+    insert_node(game->board, params[1], params[2], *units, NULL, NULL);
 
-    fprintf(log, "Unidade %s inserida no tabuleiro em posição (%d, %d).\n", part, params[1], params[2]);
+    print_log(log, LOG_EVENTS, "Unidade %s inserida no tabuleiro em posição (%d, %d).\n", part, params[1], params[2]);
 
-    char faction_name[3];
-    sprintf(faction_name, "F%c", part[0]);
-    faction_t *faction = get_faction(&(*factions), faction_name);
     if(faction == NULL) {
-        fprintf(log, "Facção não encontrada.\n");
+        LOG_FIXED(log, LOG_EVENTS, "Facção não encontrada.\n");
         return;
     }
 
     faction->power += params[0] == SOLDIER ? 25 : 10;
-    fprintf(log, "Poder da facção %s aumentado em %d unidades.\n", faction->name, params[0] == SOLDIER ? 25 : 10);
+    print_log(log, LOG_EVENTS, "Poder da facção %s aumentado em %d unidades.\n", faction->name, params[0] == SOLDIER ? 25 : 10);
 
-    print_board(log, *board);
-    fprintf(log, "\n");
+    print_board(log, game->board);
+    LOG_FIXED(log, LOG_EVENTS, "\n");
 }
 
 /**
@@ -310,9 +312,7 @@ void handle_position_unit(FILE *log, board_t **board, faction_t **factions, unit
  * atualiza sua localização e registra as mudanças no log. Além disso, atualiza o estado
  * do tabuleiro após o movimento da unidade.
  * 
- * @param log Um ponteiro para um arquivo onde o log será escrito. Deve estar previamente aberto.
- * @param board Um ponteiro para o tabuleiro de jogo. A função assume que o tabuleiro está corretamente inicializado.
- * @param units Um ponteiro para um ponteiro da lista de unidades. A função assume que essa lista está corretamente inicializada.
+ * @param game A partida onde a ação é aplicada.
  * @param part O nome da unidade que está sendo movida. Deve ser uma string válida.
  * @param params Um array de inteiros contendo os parâmetros do movimento:
  *               - params[1]: Nova coordenada x da unidade.
@@ -320,49 +320,95 @@ void handle_position_unit(FILE *log, board_t **board, faction_t **factions, unit
  * 
  * @pre O arquivo de log deve estar aberto para escrita.
  * @pre O tabuleiro (`board`) deve estar inicializado e não ser nulo.
- * @pre A lista de unidades (`units`) deve estar inicializada e não ser nula.
+ * @pre O índice de unidades (`unit_index`) deve estar inicializado e não ser nulo.
  * @pre O nome da unidade (`part`) deve ser uma string válida e existente na lista de unidades.
  * @pre Os parâmetros (`params`) devem conter as coordenadas válidas para o movimento da unidade.
  * 
  * @post A unidade será movida para a nova posição especificada.
  * @post O estado atualizado do tabuleiro será impresso no log.
  */
-void handle_move(FILE *log, board_t *board, unit_t **units, char part[MAX_PART_LEN], int *params) {
-    fprintf(log, "=== Movimento de unidade ===\n");
-    fprintf(log, "Unidade %s movida para posição (%d, %d).\n", part, params[1], params[2]);
-    unit_t *unit = get_unit(units, part);
+void handle_move(game_t *game, char part[MAX_PART_LEN], int *params) {
+    log_t *log = game->log;
+    board_t *board = game->board;
+
+    LOG_FIXED(log, LOG_EVENTS, "=== Movimento de unidade ===\n");
+    print_log(log, LOG_EVENTS, "Unidade %s movida para posição (%d, %d).\n", part, params[1], params[2]);
+    unit_t *unit = get_index(&game->unit_index, part);
     if(unit == NULL) {
-        fprintf(log, "Unidade não encontrada.\n");
+        LOG_FIXED(log, LOG_EVENTS, "Unidade não encontrada.\n");
         return;
     }
 
-    faction_t *faction_on = get_faction_board(board, unit->x, unit->y);
-    building_t *building_on = get_building_board(board, unit->x, unit->y);
-    unit_t *unit_on = get_unit_board(board, unit->x, unit->y);
-    unit_t *unit1_on = get_unit1_board(board, unit->x, unit->y);
-    unit_t *unit2_on = get_unit2_board(board, unit->x, unit->y);
-
-    remove_node(board, unit->x, unit->y);
-    insert_node(board, unit->x, unit->y, NULL, building_on, faction_on);
-    if(strcmp(unit->name, unit_on->name) == 0){
-        insert_node(board, unit->x, unit->y, unit1_on, NULL, NULL);
-        insert_node(board, unit->x, unit->y, unit2_on, NULL, NULL);
+    move_unit(board, unit, params[1], params[2]);
+    move_unit_store(&game->unit_store, unit->handle, params[1], params[2]);
+    move_spatial(&game->spatial, unit->handle, params[1], params[2]);
+    
+    print_board(log, board);
+    LOG_FIXED(log, LOG_EVENTS, "\n");
+}
+
+/**
+ * @brief Faz uma unidade caminhar até uma posição pelo caminho de menor custo e registra o trajeto no log.
+ *
+ * Diferente de `handle_move`, a unidade não salta direto para o destino: o caminho é
+ * calculado com A* sobre o mapa de terrenos (veja path.c), e cada célula do caminho
+ * custa de acordo com o seu terreno. Se houver um limite de custo, a unidade para na
+ * última célula do caminho que couber nele.
+ *
+ * @param game A partida onde a ação é aplicada.
+ * @param part O nome da unidade que está caminhando. Deve ser uma string válida.
+ * @param params Um array de inteiros contendo os parâmetros da caminhada:
+ *               - params[1]: Linha de destino.
+ *               - params[2]: Coluna de destino.
+ * @param budget O custo máximo da caminhada, ou um valor negativo para ir até o destino.
+ *
+ * @post A unidade estará no destino, ou na última célula do caminho alcançável com `budget`.
+ * @post O trajeto e o estado atualizado do tabuleiro serão registrados no log.
+ */
+void handle_walk(game_t *game, char part[MAX_PART_LEN], int *params, int budget) {
+    log_t *log = game->log;
+    pathfinder_t *pathfinder = &game->pathfinder;
+
+    LOG_FIXED(log, LOG_EVENTS, "=== Caminhada de unidade ===\n");
+    unit_t *unit = get_index(&game->unit_index, part);
+    if(unit == NULL) {
+        LOG_FIXED(log, LOG_EVENTS, "Unidade não encontrada.\n\n");
+        return;
     }
-    else if(strcmp(unit->name, unit1_on->name) == 0){
-        insert_node(board, unit->x, unit->y, unit_on, NULL, NULL);
-        insert_node(board, unit->x, unit->y, unit2_on, NULL, NULL);
+
+    int cost = find_path(pathfinder, game->terrain, unit->x, unit->y, params[1], params[2]);
+    if(cost == PATH_UNREACHABLE) {
+        print_log(log, LOG_EVENTS, "Nenhum caminho de (%d, %d) até (%d, %d).\n\n", unit->x, unit->y, params[1], params[2]);
+        return;
     }
-    else if(strcmp(unit->name, unit2_on->name) == 0){
-        insert_node(board, unit->x, unit->y, unit_on, NULL, NULL);
-        insert_node(board, unit->x, unit->y, unit1_on, NULL, NULL);
+
+    // Anda pelo caminho enquanto o custo acumulado couber no limite
+    int columns = game->terrain->columns;
+    int steps = 0, spent = 0;
+    while(steps < pathfinder->path_length) {
+        int cell = pathfinder->path[steps];
+        int next_cost = step_cost(game->terrain, cell / columns, cell % columns);
+        if(budget >= 0 && spent + next_cost > budget) break;
+        spent += next_cost;
+        steps++;
     }
-    
-    insert_node(board, params[1], params[2], unit, NULL, NULL);
-    unit->x = params[1];
-    unit->y = params[2];
-    
-    print_board(log, board);
-    fprintf(log, "\n");
+
+    if(steps > 0) {
+        int cell = pathfinder->path[steps - 1];
+        move_unit(game->board, unit, cell / columns, cell % columns);
+        move_unit_store(&game->unit_store, unit->handle, unit->x, unit->y);
+        move_spatial(&game->spatial, unit->handle, unit->x, unit->y);
+    }
+
+    if(steps == pathfinder->path_length) {
+        print_log(log, LOG_EVENTS, "Unidade %s caminhou até (%d, %d) em %d passos, com custo %d.\n", part, unit->x, unit->y, steps, spent);
+    } else {
+        print_log(log, LOG_EVENTS, "Unidade %s parou em (%d, %d), a caminho de (%d, %d), após %d passos, com custo %d.\n",
+                  part, unit->x, unit->y, params[1], params[2], steps, spent);
+    }
+
+    print_board(log, game->board);
+    LOG_FIXED(log, LOG_EVENTS, "\n");
 }
 
 /**
@@ -371,51 +417,43 @@ void handle_move(FILE *log, board_t *board, unit_t **units, char part[MAX_PART_L
  * Esta função permite que uma unidade específica colete recursos do mapa. A quantidade de recursos
  * coletados depende do tipo de unidade e do tipo de terreno onde a unidade está localizada.
  * 
- * @param log Um ponteiro para um arquivo onde o log será escrito. Deve estar previamente aberto para escrita.
- * @param factions Um ponteiro para um ponteiro da lista de facções. A função assume que essa lista está corretamente inicializada.
- * @param units Um ponteiro para um ponteiro da lista de unidades. A função assume que essa lista está corretamente inicializada.
- * @param columns O número de colunas no mapa.
- * @param rows O número de linhas no mapa.
- * @param map Uma matriz que representa o mapa, onde os valores indicam o tipo de terreno.
+ * @param game A partida onde a ação é aplicada.
  * @param part O nome da unidade que está coletando recursos. Deve ser uma string válida correspondente a uma unidade existente.
  * 
  * @pre O arquivo de log deve estar aberto para escrita.
- * @pre O ponteiro para a lista de facções (`factions`) deve apontar para uma lista inicializada e não ser nulo.
- * @pre O ponteiro para a lista de unidades (`units`) deve apontar para uma lista inicializada e não ser nulo.
- * @pre O mapa (`map`) deve ser uma matriz válida com dimensões `columns` x `rows`.
+ * @pre O índice de facções (`faction_index`) deve estar inicializado e não ser nulo.
+ * @pre O índice de unidades (`unit_index`) deve estar inicializado e não ser nulo.
+ * @pre O mapa de terrenos (`terrain`) deve ter sido gerado com `generate_terrain`.
  * @pre O nome da unidade (`part`) deve ser uma string válida que corresponde a uma unidade existente no jogo.
  * 
  * @post A função atualizará os recursos da facção à qual a unidade pertence, com base no tipo de unidade e no tipo de terreno onde a unidade está localizada.
  * @post A coleta de recursos será registrada no log, incluindo os novos valores de recursos da facção.
  */
-void handle_collect(FILE *log, faction_t **factions, unit_t **units, int columns, int rows, int map[columns][rows], char part[MAX_PART_LEN]) {
-    fprintf(log, "=== Coleta de recursos ===\n");
-    unit_t *unit = get_unit(&(*units), part);
+void handle_collect(game_t *game, char part[MAX_PART_LEN]) {
+    log_t *log = game->log;
+
+    LOG_FIXED(log, LOG_EVENTS, "=== Coleta de recursos ===\n");
+    unit_t *unit = get_index(&game->unit_index, part);
     if(unit == NULL) {
-        fprintf(log, "Unidade não encontrada.\n");
+        LOG_FIXED(log, LOG_EVENTS, "Unidade não encontrada.\n");
         return;
     }
-    char faction_name[3];
-    sprintf(faction_name, "F%c", part[0]);
-    faction_t *faction = get_faction(&(*factions), faction_name);
+    char faction_name[3] = {'F', part[0], '\0'};
+    faction_t *faction = get_index(&game->faction_index, faction_name);
     if(faction == NULL) {
-        fprintf(log, "Facção não encontrada.\n");
+        LOG_FIXED(log, LOG_EVENTS, "Facção não encontrada.\n");
         return;
     }
 
-    int resources; 
-
-    if(unit->type == SOLDIER) {
-        resources = map[unit->x][unit->y] == 0 ? 30 : map[unit->x][unit->y] == 1 ? 20 : 10;
-        faction->resources +=  resources;
-    }
-    else if(unit->type == EXPLORER){
-        resources = map[unit->x][unit->y] == 0 ? 50 : map[unit->x][unit->y] == 1 ? 40 : 30;
-        faction->resources += resources;
+    // Uma coleta isolada é um lote de uma unidade, com a mesma tabela de rendimentos da coleta em lote
+    int resources = 0;
+    if(unit->handle != UNIT_NO_HANDLE) {
+        collect_units(&game->unit_store, &unit->handle, 1, game->terrain, &resources, NULL, 0);
     }
-    
-    fprintf(log, "Facção %s coletou %d recursos.\n", part, resources);
-    fprintf(log, "%s agora possui %d recursos.\n\n", faction->name, faction->resources);
+    faction->resources += resources;
+
+    print_log(log, LOG_EVENTS, "Facção %s coletou %d recursos.\n", part, resources);
+    print_log(log, LOG_EVENTS, "%s agora possui %d recursos.\n\n", faction->name, faction->resources);
 }
 
 /**
@@ -425,10 +463,7 @@ void handle_collect(FILE *log, faction_t **factions, unit_t **units, int columns
  * insere o edifício no tabuleiro e atualiza os recursos e poder da facção envolvida. 
  * Também imprime o estado atual do tabuleiro no log.
  * 
- * @param log Um ponteiro para um arquivo onde o log será escrito. Deve estar previamente aberto.
- * @param board Um ponteiro para um ponteiro para o tabuleiro de jogo. A função assume que o tabuleiro está corretamente inicializado.
- * @param factions Um ponteiro para um ponteiro da lista de facções. A função assume que essa lista está corretamente inicializada.
- * @param buildings Um ponteiro para um ponteiro para a lista de edifícios. A função assume que essa lista está corretamente inicializada.
+ * @param game A partida onde a ação é aplicada.
  * @param part O nome da facção que está construindo o edifício. Deve ser uma string válida.
  * @param params Um array de inteiros contendo os parâmetros da construção. Espera-se que:
  *               - params[0]: Tipo do edifício.
@@ -436,7 +471,7 @@ void handle_collect(FILE *log, faction_t **factions, unit_t **units, int columns
  *               - params[3]: Coordenada y da construção.
  * 
  * @pre O arquivo de log deve estar aberto para escrita.
- * @pre A lista de facções deve estar inicializada e não nula.
+ * @pre O índice de facções deve estar inicializado e não nulo.
  * @pre A lista de edifícios deve estar inicializada e não nula.
  * @pre O tabuleiro deve estar inicializado e não nulo.
  * @pre O nome da facção deve ser uma string válida e existente na lista de facções.
@@ -447,20 +482,23 @@ void handle_collect(FILE *log, faction_t **factions, unit_t **units, int columns
  * @post Os recursos e o poder da facção serão atualizados.
  * @post O estado atual do tabuleiro será impresso no log.
  */
-void handle_building(FILE *log, board_t **board, faction_t **factions, building_t **buildings, char *part, int *params) {
-    fprintf(log, "=== Construção de Edifício ===\n");
-    fprintf(log, "Construir um edifício para a facção %s em (%d, %d).\n", part, params[2], params[3]);
+void handle_building(game_t *game, char *part, int *params) {
+    log_t *log = game->log;
+    building_t **buildings = &game->buildings;
+
+    LOG_FIXED(log, LOG_EVENTS, "=== Construção de Edifício ===\n");
+    print_log(log, LOG_EVENTS, "Construir um edifício para a facção %s em (%d, %d).\n", part, params[2], params[3]);
 
     // Inserir o edifício no registro de edifícios
     insert_building(&(*buildings), params[2], params[3], part, params[0]);
 
     // Inserir o edifício na placa do jogo
-    insert_node(*board, params[2], params[3], NULL, *buildings, NULL);
+    insert_node(game->board, params[2], params[3], NULL, *buildings, NULL);
 
     // Encontrar a facção correspondente
-    faction_t *faction = get_faction(&(*factions), part);
+    faction_t *faction = get_index(&game->faction_index, part);
     if (faction == NULL) {
-        fprintf(log, "Facção %s não encontrada. Construção cancelada.\n", part);
+        print_log(log, LOG_EVENTS, "Facção %s não encontrada. Construção cancelada.\n", part);
         return;
     }
 
@@ -485,15 +523,15 @@ void handle_building(FILE *log, board_t **board, faction_t **factions, building_
     faction->power += power_increase;
 
     // Registrar os recursos e poder atualizados da facção
-    fprintf(log, "Recursos da facção %s após a construção: %d\n", faction->name, faction->resources);
-    fprintf(log, "Poder da facção %s após a construção: %d\n", faction->name, faction->power);
+    print_log(log, LOG_EVENTS, "Recursos da facção %s após a construção: %d\n", faction->name, faction->resources);
+    print_log(log, LOG_EVENTS, "Poder da facção %s após a construção: %d\n", faction->name, faction->power);
 
     // Imprimir o estado atualizado do tabuleiro no log
-    fprintf(log, "Estado atualizado do tabuleiro:\n");
-    print_board(log, *board);
+    LOG_FIXED(log, LOG_BOARD, "Estado atualizado do tabuleiro:\n");
+    print_board(log, game->board);
 
     // Espaço em branco para separar entradas no log
-    fprintf(log, "\n");
+    LOG_FIXED(log, LOG_EVENTS, "\n");
 }
 
 /**
@@ -502,47 +540,50 @@ void handle_building(FILE *log, board_t **board, faction_t **factions, building_
  * Esta função registra a tentativa de defesa de uma facção e atualiza os recursos das facções envolvidas
  * se a facção defendida corresponder à facção atacada no histórico de combate. As atualizações são registradas no log.
  * 
- * @param log Um ponteiro para um arquivo onde o log será escrito. Deve estar previamente aberto.
- * @param factions Um ponteiro para um ponteiro da lista de facções. A função assume que essa lista está corretamente inicializada.
+ * @param game A partida onde a ação é aplicada.
  * @param part O nome da facção que está se defendendo. Deve ser uma string com no máximo MAX_PART_LEN caracteres.
  * 
  * @pre O arquivo de log deve estar aberto para escrita.
- * @pre A lista de facções deve estar inicializada e não nula.
+ * @pre O índice de facções deve estar inicializado e não nulo.
  * @pre O nome da facção deve ser uma string válida e existente na lista de facções.
- * @pre O histórico de combate (history) deve estar inicializado corretamente e conter informações válidas.
+ * @pre O histórico de ataques da partida (`game->history`) deve estar inicializado corretamente e conter informações válidas.
  * 
  * @post A tentativa de defesa será registrada no log.
  * @post Se a facção defendida for a mesma que a facção atacada no histórico, os recursos serão atualizados conforme o histórico.
  * @post Atualizações nos recursos das facções envolvidas serão registradas no log.
  */
-void handle_defend(FILE *log, faction_t **factions, char part[MAX_PART_LEN]) {
-    fprintf(log, "=== Defesa iniciada ===\n");
-    fprintf(log, "Facção defendendo: %s\n", part);
+void handle_defend(game_t *game, char part[MAX_PART_LEN]) {
+    log_t *log = game->log;
+    name_index_t *faction_index = &game->faction_index;
+    history_t *history = &game->history;
+
+    LOG_FIXED(log, LOG_EVENTS, "=== Defesa iniciada ===\n");
+    print_log(log, LOG_EVENTS, "Facção defendendo: %s\n", part);
 
-    faction_t *defending_faction = get_faction(&(*factions), part);
+    faction_t *defending_faction = get_index(faction_index, part);
 
     if (defending_faction == NULL) {
-        fprintf(log, "Facção %s não encontrada.\n", part);
+        print_log(log, LOG_EVENTS, "Facção %s não encontrada.\n", part);
         return;
     }
 
-    if (strcmp(history.defending_faction, part) == 0) {
-        fprintf(log, "Recursos roubados na última rodada de ataque: %d\n", history.stolen_resources);
+    if (strcmp(history->defending_faction, part) == 0) {
+        print_log(log, LOG_EVENTS, "Recursos roubados na última rodada de ataque: %d\n", history->stolen_resources);
 
-        faction_t *attacking_faction = get_faction(&(*factions), history.attacking_faction);
+        faction_t *attacking_faction = get_index(faction_index, history->attacking_faction);
 
         if (attacking_faction == NULL) {
-            fprintf(log, "Facção atacante %s não encontrada.\n", history.attacking_faction);
+            print_log(log, LOG_EVENTS, "Facção atacante %s não encontrada.\n", history->attacking_faction);
             return;
         }
 
-        defending_faction->resources += history.stolen_resources;
-        attacking_faction->resources -= history.stolen_resources;
+        defending_faction->resources += history->stolen_resources;
+        attacking_faction->resources -= history->stolen_resources;
 
-        fprintf(log, "Recursos da facção %s após a defesa: %d\n", defending_faction->name, defending_faction->resources);
-        fprintf(log, "Recursos da facção %s após o ataque: %d\n\n", attacking_faction->name, attacking_faction->resources);
+        print_log(log, LOG_EVENTS, "Recursos da facção %s após a defesa: %d\n", defending_faction->name, defending_faction->resources);
+        print_log(log, LOG_EVENTS, "Recursos da facção %s após o ataque: %d\n\n", attacking_faction->name, attacking_faction->resources);
     } else {
-        fprintf(log, "Nenhuma ação de defesa executada nesta rodada.\n\n");
+        LOG_FIXED(log, LOG_EVENTS, "Nenhuma ação de defesa executada nesta rodada.\n\n");
     }
 }
 
@@ -551,15 +592,19 @@ void handle_defend(FILE *log, faction_t **factions, char part[MAX_PART_LEN]) {
  * @brief Atualiza o poder de uma facção específica e registra a mudança em um arquivo de log.
  *
  * A função `handle_earn` encontra a facção com o nome especificado na lista encadeada `factions`,
- * atualiza o seu poder para o valor fornecido e registra essa mudança em um arquivo de log "saida.txt".
+ * atualiza o seu poder para o valor fornecido e registra essa mudança no log da partida.
  *
- * @param factions Ponteiro para o ponteiro da lista encadeada de facções.
+ * @param game A partida onde a ação é aplicada.
  * @param faction_name Nome da facção cujo poder será atualizado.
  * @param power Novo valor de poder a ser atribuído à facção.
  */
-void handle_earn(FILE *log, faction_t **factions, char faction_name[MAX_PART_LEN], int power)
+void handle_earn(game_t *game, char faction_name[MAX_PART_LEN], int power)
 {
-    faction_t* faction = get_faction(&(*factions), faction_name);
+    faction_t* faction = get_index(&game->faction_index, faction_name);
+    if (faction == NULL) {
+        LOG_FIXED(game->log, LOG_EVENTS, "Facção não encontrada.\n");
+        return;
+    }
     faction->power += power;
-    fprintf(log, "A facção %s agora tem %d poder.\n", faction->name, faction->power);
-}
\ No newline at end of file
+    print_log(game->log, LOG_EVENTS, "A facção %s agora tem %d poder.\n", faction->name, faction->power);
+}
@@ -0,0 +1,180 @@
+/**
+ * @file index.c
+ * @brief Índice de objetos do jogo por nome, com endereçamento aberto.
+ *
+ * As listas encadeadas de unidades e facções continuam sendo a forma de guardar os
+ * objetos, mas buscar um nome nelas exige percorrer a lista inteira. Este índice
+ * mantém, ao lado de cada lista, uma tabela hash (FNV-1a com sondagem linear) que
+ * associa o nome de cada objeto ao seu endereço, permitindo buscas em tempo constante.
+ *
+ * A chave de cada entrada aponta para o nome guardado no próprio objeto, portanto um
+ * objeto deve ser removido do índice antes de ter sua memória liberada.
+ */
+
+#include "index.h"
+
+#define INDEX_MIN_CAPACITY 16
+
+/**
+ * @brief Marcador das entradas removidas, que não podem interromper uma sondagem.
+ */
+static const char INDEX_TOMBSTONE[] = "";
+
+/**
+ * @brief Calcula o hash FNV-1a de um nome.
+ *
+ * @param name O nome a ser processado.
+ * @return O hash do nome.
+ */
+static unsigned int hash_name(const char *name) {
+    unsigned int hash = 2166136261u;
+    while (*name != '\0') {
+        hash ^= (unsigned char) *name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Procura a entrada de um nome na tabela.
+ *
+ * @param index O índice onde será feita a busca.
+ * @param name O nome procurado.
+ * @param hash O hash do nome.
+ * @return A entrada do nome, ou NULL se o nome não estiver no índice.
+ */
+static index_entry_t *find_entry(const name_index_t *index, const char *name, unsigned int hash) {
+    if (index->capacity == 0) return NULL;
+
+    size_t mask = index->capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        index_entry_t *entry = &index->entries[i];
+        if (entry->key == NULL) return NULL; // Entrada vazia encerra a sondagem
+        if (entry->key != INDEX_TOMBSTONE && entry->hash == hash && strcmp(entry->key, name) == 0) {
+            return entry;
+        }
+    }
+}
+
+/**
+ * @brief Realoca a tabela com uma nova capacidade, descartando as entradas removidas.
+ *
+ * @param index O índice a ser redimensionado.
+ * @param capacity A nova capacidade, potência de 2.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar.
+ */
+static int resize_index(name_index_t *index, size_t capacity) {
+    index_entry_t *entries = (index_entry_t *) calloc(capacity, sizeof(index_entry_t));
+    if (entries == NULL) return 1;
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < index->capacity; i++) {
+        index_entry_t *entry = &index->entries[i];
+        if (entry->key == NULL || entry->key == INDEX_TOMBSTONE) continue;
+
+        size_t j = entry->hash & mask;
+        while (entries[j].key != NULL) j = (j + 1) & mask;
+        entries[j] = *entry;
+    }
+
+    free(index->entries);
+    index->entries = entries;
+    index->capacity = capacity;
+    index->tombstones = 0;
+    return 0;
+}
+
+/**
+ * @brief Inicializa um índice vazio.
+ *
+ * A tabela só é alocada na primeira inserção.
+ *
+ * @param index O índice a ser inicializado.
+ */
+void init_index(name_index_t *index) {
+    index->entries = NULL;
+    index->capacity = 0;
+    index->count = 0;
+    index->tombstones = 0;
+}
+
+/**
+ * @brief Associa um nome a um objeto no índice.
+ *
+ * Se o nome já estiver no índice, o objeto associado é substituído. A tabela dobra de
+ * tamanho quando as entradas ocupadas e removidas passam de 70% da capacidade.
+ *
+ * @param index O índice onde o nome será inserido.
+ * @param name O nome do objeto. Deve permanecer válido enquanto estiver no índice.
+ * @param value O objeto associado ao nome.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar.
+ */
+int insert_index(name_index_t *index, const char *name, void *value) {
+    unsigned int hash = hash_name(name);
+
+    index_entry_t *entry = find_entry(index, name, hash);
+    if (entry != NULL) {
+        entry->key = name;
+        entry->value = value;
+        return 0;
+    }
+
+    if ((index->count + index->tombstones + 1) * 10 > index->capacity * 7) {
+        size_t capacity = index->capacity == 0 ? INDEX_MIN_CAPACITY : index->capacity;
+        while ((index->count + 1) * 10 > capacity * 5) capacity *= 2; // Volta a no máximo 50% de ocupação
+        if (resize_index(index, capacity) != 0) return 1;
+    }
+
+    size_t mask = index->capacity - 1;
+    size_t i = hash & mask;
+    while (index->entries[i].key != NULL && index->entries[i].key != INDEX_TOMBSTONE) {
+        i = (i + 1) & mask;
+    }
+    if (index->entries[i].key == INDEX_TOMBSTONE) index->tombstones--;
+
+    index->entries[i].key = name;
+    index->entries[i].hash = hash;
+    index->entries[i].value = value;
+    index->count++;
+    return 0;
+}
+
+/**
+ * @brief Busca o objeto associado a um nome.
+ *
+ * @param index O índice onde será feita a busca.
+ * @param name O nome procurado.
+ * @return O objeto associado ao nome, ou NULL se o nome não estiver no índice.
+ */
+void *get_index(const name_index_t *index, const char *name) {
+    index_entry_t *entry = find_entry(index, name, hash_name(name));
+    return entry != NULL ? entry->value : NULL;
+}
+
+/**
+ * @brief Remove um nome do índice.
+ *
+ * @param index O índice de onde o nome será removido.
+ * @param name O nome a ser removido. Se não estiver no índice, nada acontece.
+ */
+void remove_index(name_index_t *index, const char *name) {
+    index_entry_t *entry = find_entry(index, name, hash_name(name));
+    if (entry == NULL) return;
+
+    entry->key = INDEX_TOMBSTONE;
+    entry->value = NULL;
+    index->count--;
+    index->tombstones++;
+}
+
+/**
+ * @brief Libera a tabela do índice.
+ *
+ * Os objetos indexados não são liberados.
+ *
+ * @param index O índice a ser liberado. Fica vazio e pode ser reutilizado.
+ */
+void free_index(name_index_t *index) {
+    free(index->entries);
+    init_index(index);
+}
@@ -0,0 +1,285 @@
+/**
+ * @file log.c
+ * @brief Escrita em buffer do log da partida (por padrão, saida.txt).
+ *
+ * As ações do jogo escrevem muitas mensagens curtas. Em vez de um `fprintf` por
+ * mensagem, o log acumula o texto em um buffer de LOG_BUFFER_SIZE bytes e só o
+ * escreve no arquivo quando ele enche ou quando o log é fechado. Os inteiros são
+ * formatados à mão por `print_log`, que entende apenas `%s`, `%d` e `%%`.
+ *
+ * Opcionalmente, a escrita no arquivo é feita por uma thread separada: o log usa dois
+ * buffers e, quando um enche, entrega-o à thread de escrita e continua preenchendo o
+ * outro. Categorias desativadas (por exemplo, as impressões do tabuleiro) são
+ * descartadas antes de qualquer formatação.
+ */
+
+#include "log.h"
+#include "profile.h"
+
+typedef struct category_name_t {
+    const char *name;
+    unsigned int category;
+} category_name_t;
+
+static const category_name_t category_names[] = {
+    {"eventos", LOG_EVENTS},
+    {"tabuleiro", LOG_BOARD},
+    {"turnos", LOG_TURNS},
+    {"resultado", LOG_RESULT},
+};
+
+/**
+ * @brief Laço da thread de escrita: escreve cada buffer pendente e o devolve como livre.
+ */
+static void *run_log_writer(void *arg) {
+    log_t *log = (log_t *) arg;
+
+    pthread_mutex_lock(&log->lock);
+    for (;;) {
+        while (log->pending == NULL && !log->stop) pthread_cond_wait(&log->ready, &log->lock);
+        if (log->pending == NULL) break; // Fechando e sem nada pendente
+
+        char *data = log->pending;
+        size_t used = log->pending_used;
+        pthread_mutex_unlock(&log->lock);
+
+        size_t written = fwrite(data, 1, used, log->file);
+
+        pthread_mutex_lock(&log->lock);
+        if (written != used) log->failed = 1;
+        log->spare = data;
+        log->pending = NULL;
+        pthread_cond_signal(&log->done);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return NULL;
+}
+
+/**
+ * @brief Esvazia o buffer atual, escrevendo-o no arquivo ou entregando-o à thread de escrita.
+ */
+static void drain_buffer(log_t *log) {
+    if (log->used == 0) return;
+    log->written += log->used;
+
+    if (!log->threaded) {
+        if (fwrite(log->buffer, 1, log->used, log->file) != log->used) log->failed = 1;
+        log->used = 0;
+        return;
+    }
+
+    pthread_mutex_lock(&log->lock);
+    while (log->pending != NULL) pthread_cond_wait(&log->done, &log->lock);
+    log->pending = log->buffer;
+    log->pending_used = log->used;
+    log->buffer = log->spare;
+    log->spare = NULL;
+    pthread_cond_signal(&log->ready);
+    pthread_mutex_unlock(&log->lock);
+    log->used = 0;
+}
+
+/**
+ * @brief Copia bytes para o buffer, esvaziando-o sempre que encher.
+ */
+static void append_log(log_t *log, const char *data, size_t length) {
+    while (length > 0) {
+        if (log->used == log->capacity) drain_buffer(log);
+        size_t chunk = log->capacity - log->used;
+        if (chunk > length) chunk = length;
+        memcpy(log->buffer + log->used, data, chunk);
+        log->used += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+/**
+ * @brief Formata um inteiro em decimal diretamente no buffer.
+ */
+static void append_int(log_t *log, int value) {
+    char digits[12];
+    char *end = digits + sizeof(digits);
+    char *start = end;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int) value : (unsigned int) value;
+
+    do {
+        *--start = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) *--start = '-';
+
+    append_log(log, start, (size_t) (end - start));
+}
+
+/**
+ * @brief Abre o log, truncando o arquivo de destino.
+ *
+ * @param log O log a ser inicializado.
+ * @param path Caminho do arquivo de log. Se for NULL, o log descarta todas as mensagens
+ *             (as categorias e `threaded` são ignorados), sem abrir arquivo nem alocar buffer.
+ * @param categories Categorias registradas (combinação de `log_category_e`).
+ * @param threaded Se diferente de 0, a escrita no arquivo é feita por uma thread separada.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se o arquivo não puder ser aberto ou a
+ *         memória não puder ser alocada.
+ */
+int open_log(log_t *log, const char *path, unsigned int categories, int threaded) {
+    memset(log, 0, sizeof(log_t));
+    if (path == NULL) return 0;
+    log->categories = categories;
+    log->capacity = LOG_BUFFER_SIZE;
+
+    log->file = fopen(path, "w");
+    if (log->file == NULL) return 1;
+
+    log->buffer = (char *) malloc(log->capacity);
+    if (log->buffer == NULL) {
+        fclose(log->file);
+        return 1;
+    }
+    if (!threaded) return 0;
+
+    // Sem o segundo buffer ou a thread, o log continua funcionando de forma síncrona
+    log->spare = (char *) malloc(log->capacity);
+    if (log->spare == NULL) return 0;
+
+    pthread_mutex_init(&log->lock, NULL);
+    pthread_cond_init(&log->ready, NULL);
+    pthread_cond_init(&log->done, NULL);
+    if (pthread_create(&log->thread, NULL, run_log_writer, log) != 0) {
+        pthread_mutex_destroy(&log->lock);
+        pthread_cond_destroy(&log->ready);
+        pthread_cond_destroy(&log->done);
+        free(log->spare);
+        log->spare = NULL;
+        return 0;
+    }
+    log->threaded = 1;
+    return 0;
+}
+
+/**
+ * @brief Escreve bytes no log.
+ *
+ * @param log O log de destino.
+ * @param category A categoria da mensagem. Se estiver desativada, nada é escrito.
+ * @param data Os bytes a serem escritos.
+ * @param length A quantidade de bytes.
+ */
+void write_log(log_t *log, unsigned int category, const char *data, size_t length) {
+    if (!LOG_ENABLED(log, category)) return;
+    PROFILE_BEGIN(start);
+    append_log(log, data, length);
+    PROFILE_END(PROFILE_LOG, start);
+}
+
+/**
+ * @brief Escreve uma mensagem formatada no log.
+ *
+ * Apenas os especificadores `%s`, `%d` e `%%` são reconhecidos; qualquer outro
+ * caractere é copiado sem alteração.
+ *
+ * @param log O log de destino.
+ * @param category A categoria da mensagem. Se estiver desativada, a mensagem nem é formatada.
+ * @param format O formato da mensagem.
+ */
+void print_log(log_t *log, unsigned int category, const char *format, ...) {
+    if (!LOG_ENABLED(log, category)) return;
+    PROFILE_BEGIN(start);
+
+    va_list args;
+    va_start(args, format);
+    const char *literal = format;
+    for (const char *c = format; *c != '\0'; c++) {
+        if (*c != '%' || (c[1] != 's' && c[1] != 'd' && c[1] != '%')) continue;
+
+        append_log(log, literal, (size_t) (c - literal));
+        c++;
+        if (*c == 's') {
+            const char *text = va_arg(args, const char *);
+            append_log(log, text, strlen(text));
+        } else if (*c == 'd') {
+            append_int(log, va_arg(args, int));
+        } else {
+            append_log(log, "%", 1);
+        }
+        literal = c + 1;
+    }
+    append_log(log, literal, strlen(literal));
+    va_end(args);
+    PROFILE_END(PROFILE_LOG, start);
+}
+
+/**
+ * @brief Escreve no arquivo tudo o que já foi registrado no log.
+ *
+ * Com a thread de escrita, a função só retorna depois que os dados chegarem ao arquivo.
+ *
+ * @param log O log a ser descarregado.
+ */
+void flush_log(log_t *log) {
+    drain_buffer(log);
+    if (log->threaded) {
+        pthread_mutex_lock(&log->lock);
+        while (log->pending != NULL) pthread_cond_wait(&log->done, &log->lock);
+        pthread_mutex_unlock(&log->lock);
+    }
+    if (log->file != NULL) fflush(log->file);
+}
+
+/**
+ * @brief Descarrega e fecha o log, encerrando a thread de escrita se houver.
+ *
+ * @param log O log a ser fechado.
+ * @return Retorna 0 se todas as escritas foram bem-sucedidas, ou 1 caso contrário.
+ */
+int close_log(log_t *log) {
+    drain_buffer(log);
+    if (log->threaded) {
+        pthread_mutex_lock(&log->lock);
+        log->stop = 1;
+        pthread_cond_signal(&log->ready);
+        pthread_mutex_unlock(&log->lock);
+        pthread_join(log->thread, NULL);
+
+        pthread_mutex_destroy(&log->lock);
+        pthread_cond_destroy(&log->ready);
+        pthread_cond_destroy(&log->done);
+    }
+
+    if (log->file != NULL && fclose(log->file) != 0) log->failed = 1;
+    free(log->buffer);
+    free(log->spare);
+    log->file = NULL;
+    log->buffer = NULL;
+    log->spare = NULL;
+    return log->failed;
+}
+
+/**
+ * @brief Converte uma lista de nomes de categorias, separados por vírgula, em flags.
+ *
+ * Os nomes aceitos são `eventos`, `tabuleiro`, `turnos` e `resultado`.
+ *
+ * @param list A lista de nomes, por exemplo "tabuleiro,turnos".
+ * @param categories Onde as flags das categorias listadas serão armazenadas.
+ * @return Retorna 0 em caso de sucesso, ou 1 se algum nome não for reconhecido.
+ */
+int parse_log_categories(const char *list, unsigned int *categories) {
+    *categories = 0;
+    while (*list != '\0') {
+        size_t length = strcspn(list, ",");
+        size_t i, count = sizeof(category_names) / sizeof(category_names[0]);
+        for (i = 0; i < count; i++) {
+            if (strlen(category_names[i].name) == length && strncmp(category_names[i].name, list, length) == 0) {
+                *categories |= category_names[i].category;
+                break;
+            }
+        }
+        if (i == count) return 1;
+        list += length;
+        if (*list == ',') list++;
+    }
+    return 0;
+}
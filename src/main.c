@@ -1,13 +1,143 @@
 #include "include.h"
 
-int main() {
-    FILE *file = fopen("entrada.txt", "r");
+#include <unistd.h>
+
+int main(int argc, char *argv[]) {
+    options_t options = {0};
+    options.log_categories = LOG_ALL;
+    options.threads = 1;
+    options.seed = RNG_DEFAULT_SEED;
+    options.bot_budget_ms = AI_DEFAULT_BUDGET_MS;
+    options.log_path = "saida.txt";
+    const char *input = "entrada.txt";
+    const char *compiled = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "k:mc:x:tj:s:n:o:p:w:r:b:")) != -1) {
+        switch (opt) {
+            case 'k':
+                // Intervalo entre tabuleiros completos; os demais quadros registram só as células alteradas
+                options.keyframe_interval = atoi(optarg);
+                break;
+            case 'm':
+                // Imprime os contadores dos pools de memória ao final da partida
+                options.pool_stats = 1;
+                break;
+            case 'x': {
+                // Categorias do log que não serão registradas, separadas por vírgula
+                unsigned int disabled;
+                if (parse_log_categories(optarg, &disabled) != 0) {
+                    printf("Categorias de log válidas: eventos, tabuleiro, turnos, resultado.\n");
+                    return 1;
+                }
+                options.log_categories &= ~disabled;
+                break;
+            }
+            case 't':
+                // Escreve o log no arquivo em uma thread separada
+                options.log_thread = 1;
+                break;
+            case 'j':
+                // Threads usadas na geração do mapa de terrenos e nas simulações
+                options.threads = atoi(optarg);
+                break;
+            case 's':
+                // Semente da partida: a mesma semente reproduz a mesma partida
+                options.seed = strtoull(optarg, NULL, 0);
+                break;
+            case 'n':
+                // Executa várias simulações do cenário e imprime as estatísticas, sem log
+                options.simulations = atoi(optarg);
+                break;
+            case 'o':
+                // Arquivo de log da partida
+                options.log_path = optarg;
+                break;
+            case 'p':
+                // Imprime o tempo gasto em cada ação, no tabuleiro e no log, em tabela ou JSON
+#ifdef PROFILE
+                if (parse_profile_format(optarg, &options.profile_format) != 0) {
+                    printf("Formatos de perfil válidos: tabela, json.\n");
+                    return 1;
+                }
+                options.profile = 1;
+                break;
+#else
+                printf("As medições de tempo requerem compilar com `make PROFILE=1`.\n");
+                return 1;
+#endif
+            case 'w': {
+                // Grava um snapshot da partida após o comando de número `turno`, no formato turno:arquivo
+                char *separator = strchr(optarg, ':');
+                options.checkpoint_turn = atoi(optarg);
+                if (separator == NULL || separator[1] == '\0' || options.checkpoint_turn <= 0) {
+                    printf("Use -w turno:arquivo, com turno maior que 0.\n");
+                    return 1;
+                }
+                options.checkpoint_path = separator + 1;
+                break;
+            }
+            case 'r':
+                // Continua a partida de um snapshot gravado com -w
+                options.restore_path = optarg;
+                break;
+            case 'b': {
+                // Partida entre IAs: após a entrada, cada facção joga `rodadas` ações, no formato rodadas[:ms]
+                char *separator = strchr(optarg, ':');
+                options.bot_rounds = atoi(optarg);
+                if (separator != NULL) options.bot_budget_ms = atoi(separator + 1);
+                if (options.bot_rounds <= 0 || options.bot_budget_ms <= 0) {
+                    printf("Use -b rodadas[:ms], com rodadas e ms maiores que 0.\n");
+                    return 1;
+                }
+                break;
+            }
+            case 'c':
+                // Compila o script de entrada para o formato binário em vez de executá-lo
+                compiled = optarg;
+                break;
+            default:
+                printf("Uso: %s [-k quadros] [-m] [-t] [-x categorias] [-j threads] [-s semente] [-n simulações] [-o log] [-p formato] [-w turno:snapshot] [-r snapshot] [-b rodadas[:ms]] [-c saida] [entrada]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (optind < argc) input = argv[optind];
+
+    // As simulações rodam em outras threads, cujas medições não são impressas
+    if (options.profile && options.simulations > 0) {
+        printf("As medições de tempo (-p) não podem ser usadas com simulações (-n).\n");
+        return 1;
+    }
+
+    // "-" lê os comandos da entrada padrão, à medida que chegam
+    FILE *file = strcmp(input, "-") == 0 ? stdin : fopen(input, "r");
     if (file == NULL) {
         printf("Failed to open the file.\n");
         return 1;
     }
 
-    read_all_file(file);
+    if (compiled != NULL) {
+        FILE *output = fopen(compiled, "wb");
+        if (output == NULL) {
+            printf("Failed to open the output file.\n");
+            fclose(file);
+            return 1;
+        }
+        int status = compile_script(file, output);
+        fclose(output);
+        fclose(file);
+        if (status != 0) {
+            printf("Falha ao compilar o script.\n");
+            return 1;
+        }
+        return 0;
+    }
+
+    if (options.simulations > 0) {
+        return run_montecarlo(file, &options);
+    }
+
+    read_all_file(file, &options);
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,250 @@
+/**
+ * @file montecarlo.c
+ * @brief Execução de muitas simulações independentes de um mesmo cenário.
+ *
+ * Ataques e combates são sorteados, então uma única partida diz pouco sobre as
+ * chances de cada facção. O executor de Monte Carlo lê o cenário uma só vez, gera o
+ * mapa de terrenos uma só vez (compartilhado, somente leitura, por todas as
+ * simulações) e aplica a mesma lista de comandos a N partidas, cada uma com o seu
+ * próprio `game_t` e o seu próprio gerador, distribuídas entre várias threads. O log
+ * é desativado nas simulações.
+ *
+ * O gerador da simulação `i` começa `i` saltos longos depois da semente (veja
+ * `stream_rng`), e os resultados de cada simulação são guardados em arrays e
+ * agregados em ordem ao final. Assim, o resultado é o mesmo para qualquer número de
+ * threads, e a simulação 0 é exatamente a partida executada sem `-n`.
+ */
+
+#include "montecarlo.h"
+#include "game.h"
+
+#include <inttypes.h>
+#include <stdatomic.h>
+
+typedef struct montecarlo_t {
+    const command_t *commands;          // Comandos do cenário, lidos uma só vez
+    size_t command_count;
+    int rows;
+    int columns;
+    int num_factions;
+    const terrain_t *terrain;           // Compartilhado por todas as simulações
+    const rng_t *streams;               // Gerador inicial de cada simulação
+    int simulations;
+    atomic_int next;                    // Próxima simulação a ser executada
+    atomic_int failed;                  // 1 se alguma partida não pôde ser criada
+
+    // Resultados, indexados por simulação (e por id de facção)
+    int *winners;                       // Id da facção vencedora, ou -1 se não houver
+    int *resources;                     // [simulação * num_factions + id]
+    int *power;
+    char (*names)[COMMAND_NAME_LEN];    // Nomes das facções na simulação 0, por id
+} montecarlo_t;
+
+/**
+ * @brief Executa uma simulação e guarda os seus resultados.
+ */
+static void run_simulation(montecarlo_t *mc, int simulation) {
+    log_t log;
+    open_log(&log, NULL, 0, 0);
+
+    game_t game;
+    if (start_game(&game, mc->rows, mc->columns, mc->num_factions, &mc->streams[simulation], mc->terrain, &log) != 0) {
+        atomic_store(&mc->failed, 1);
+        return;
+    }
+
+    for (size_t i = 0; i < mc->command_count; i++) {
+        apply_command(&game, &mc->commands[i]);
+    }
+
+    faction_t *winner = finish_game(&game);
+    mc->winners[simulation] = winner != NULL ? winner->id : -1;
+
+    int *resources = mc->resources + (size_t) simulation * mc->num_factions;
+    int *power = mc->power + (size_t) simulation * mc->num_factions;
+    for (faction_t *faction = game.factions; faction != NULL; faction = faction->next) {
+        if (faction->id < 0 || faction->id >= mc->num_factions) continue;
+        resources[faction->id] = faction->resources;
+        power[faction->id] = faction->power;
+        if (simulation == 0) memcpy(mc->names[faction->id], faction->name, COMMAND_NAME_LEN);
+    }
+
+    end_game(&game);
+    close_log(&log);
+}
+
+/**
+ * @brief Laço de uma thread: executa simulações até que todas tenham sido distribuídas.
+ */
+static void *run_worker(void *arg) {
+    montecarlo_t *mc = (montecarlo_t *) arg;
+    int simulation;
+    while ((simulation = atomic_fetch_add(&mc->next, 1)) < mc->simulations) {
+        run_simulation(mc, simulation);
+    }
+    // As partidas devolvem os objetos aos pools; os blocos são reaproveitados entre elas
+    release_pools();
+    return NULL;
+}
+
+/**
+ * @brief Distribui as simulações entre `threads` threads, incluindo a atual.
+ */
+static void run_workers(montecarlo_t *mc, int threads) {
+    if (threads > MONTECARLO_MAX_THREADS) threads = MONTECARLO_MAX_THREADS;
+    if (threads > mc->simulations) threads = mc->simulations;
+    if (threads < 1) threads = 1;
+
+    atomic_init(&mc->next, 0);
+    atomic_init(&mc->failed, 0);
+
+    pthread_t workers[threads];
+    int started[threads];
+    for (int i = 1; i < threads; i++) {
+        started[i] = pthread_create(&workers[i], NULL, run_worker, mc) == 0;
+    }
+    // As simulações de threads que não puderam ser criadas ficam com as demais
+    run_worker(mc);
+    for (int i = 1; i < threads; i++) {
+        if (started[i]) pthread_join(workers[i], NULL);
+    }
+}
+
+/**
+ * @brief Imprime a distribuição de vitórias e a média e a variância dos recursos e do
+ *        poder de cada facção.
+ *
+ * As somas são acumuladas na ordem das simulações (algoritmo de Welford), de modo que
+ * o resultado não depende da ordem em que as threads terminaram.
+ */
+static void print_montecarlo(const montecarlo_t *mc, FILE *out, uint64_t seed) {
+    int n = mc->simulations;
+    int no_winner = 0;
+    for (int s = 0; s < n; s++) {
+        if (mc->winners[s] < 0) no_winner++;
+    }
+
+    fprintf(out, "=== Monte Carlo: %d simulações (semente %" PRIu64 ") ===\n", n, seed);
+    // "facção" e "vitórias" têm caracteres de dois bytes, daí as larguras maiores
+    fprintf(out, "%-14s %10s %8s %14s %14s %14s %14s\n",
+            "facção", "vitórias", "%", "recursos", "var. recursos", "poder", "var. poder");
+
+    for (int id = 0; id < mc->num_factions; id++) {
+        int wins = 0;
+        double mean_resources = 0.0, m2_resources = 0.0;
+        double mean_power = 0.0, m2_power = 0.0;
+
+        for (int s = 0; s < n; s++) {
+            if (mc->winners[s] == id) wins++;
+
+            double resources = mc->resources[(size_t) s * mc->num_factions + id];
+            double delta = resources - mean_resources;
+            mean_resources += delta / (s + 1);
+            m2_resources += delta * (resources - mean_resources);
+
+            double power = mc->power[(size_t) s * mc->num_factions + id];
+            delta = power - mean_power;
+            mean_power += delta / (s + 1);
+            m2_power += delta * (power - mean_power);
+        }
+
+        double var_resources = n > 1 ? m2_resources / (n - 1) : 0.0;
+        double var_power = n > 1 ? m2_power / (n - 1) : 0.0;
+        fprintf(out, "%-12s %9d %7.2f%% %14.2f %14.2f %14.2f %14.2f\n",
+                mc->names[id][0] != '\0' ? mc->names[id] : "-", wins, 100.0 * wins / n,
+                mean_resources, var_resources, mean_power, var_power);
+    }
+
+    if (no_winner > 0) {
+        fprintf(out, "Sem vencedor em %d simulações.\n", no_winner);
+    }
+}
+
+/**
+ * @brief Executa várias simulações independentes do cenário e imprime as estatísticas.
+ *
+ * @param file O arquivo de entrada, aberto para leitura. É fechado pela função.
+ * @param options Opções de execução: `simulations` simulações, distribuídas entre
+ *                `threads` threads, a partir da semente `seed`.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se o arquivo não puder ser lido ou a
+ *         memória não puder ser alocada.
+ */
+int run_montecarlo(FILE *file, options_t *options) {
+    source_t source;
+    if (open_source(&source, file) != 0) {
+        printf("Falha ao ler o arquivo de entrada.\n");
+        fclose(file);
+        return 1;
+    }
+
+    montecarlo_t mc;
+    memset(&mc, 0, sizeof(montecarlo_t));
+    mc.simulations = options->simulations;
+
+    int header = read_header(&source, &mc.rows, &mc.columns, &mc.num_factions);
+    if (header != 0) {
+        printf(header == 1 ? "Falha ao ler as dimensões do tabuleiro.\n" : "Falha ao ler o número de facções.\n");
+        close_source(&source);
+        fclose(file);
+        return 1;
+    }
+
+    // O cenário é analisado uma única vez, antes das simulações
+    command_t *commands;
+    int status = read_all_commands(&source, &commands, &mc.command_count);
+    close_source(&source);
+    fclose(file);
+    if (status != 0) {
+        printf("Falha ao ler os comandos.\n");
+        return 1;
+    }
+    mc.commands = commands;
+
+    // O terreno usa o primeiro sorteio da semente, como na partida única
+    rng_t rng;
+    seed_rng(&rng, options->seed);
+    terrain_t *terrain = create_terrain(mc.rows, mc.columns);
+    rng_t *streams = (rng_t *) malloc((size_t) mc.simulations * sizeof(rng_t));
+    size_t slots = (size_t) mc.simulations * (mc.num_factions > 0 ? mc.num_factions : 1);
+    mc.winners = (int *) malloc((size_t) mc.simulations * sizeof(int));
+    mc.resources = (int *) calloc(slots, sizeof(int));
+    mc.power = (int *) calloc(slots, sizeof(int));
+    mc.names = calloc(mc.num_factions > 0 ? mc.num_factions : 1, COMMAND_NAME_LEN);
+    if (terrain == NULL || streams == NULL || mc.winners == NULL || mc.resources == NULL || mc.power == NULL || mc.names == NULL) {
+        printf("Falha ao alocar as simulações.\n");
+        status = 1;
+    } else {
+        generate_terrain(terrain, next_rng(&rng), options->threads);
+        mc.terrain = terrain;
+
+        // A simulação s usa a mesma sequência de `stream_rng(seed, s, 0)`, obtida com um
+        // salto longo a partir da anterior; o primeiro sorteio é descartado, como o do
+        // terreno na partida única
+        rng_t chain;
+        seed_rng(&chain, options->seed);
+        for (int s = 0; s < mc.simulations; s++) {
+            streams[s] = chain;
+            next_rng(&streams[s]);
+            long_jump_rng(&chain);
+        }
+        mc.streams = streams;
+
+        run_workers(&mc, options->threads);
+        if (atomic_load(&mc.failed)) {
+            printf("Falha ao criar o tabuleiro.\n");
+            status = 1;
+        } else {
+            print_montecarlo(&mc, stdout, options->seed);
+        }
+    }
+
+    free(commands);
+    free_terrain(terrain);
+    free(streams);
+    free(mc.winners);
+    free(mc.resources);
+    free(mc.power);
+    free(mc.names);
+    return status;
+}
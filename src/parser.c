@@ -0,0 +1,534 @@
+/**
+ * @file parser.c
+ * @brief Leitura dos comandos do arquivo de entrada.
+ *
+ * O arquivo de entrada é mapeado em memória (ou lido de uma vez, quando não é um
+ * arquivo regular) e percorrido por um analisador escrito à mão: cada linha vira um
+ * registro `command_t`, com a ação já convertida para `action_e` por uma tabela hash
+ * perfeita e os inteiros convertidos sem passar por `fscanf`. Scripts compilados
+ * (veja script.c) são reconhecidos pelo número mágico e lidos sem análise de texto.
+ *
+ * Com `open_stream`, a entrada de um pipe ou FIFO é lida aos poucos para um buffer
+ * circular de tamanho fixo, e cada comando é entregue assim que a sua linha chega
+ * inteira, mesmo que ela tenha sido dividida entre várias leituras.
+ */
+
+#include "parser.h"
+#include "script.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define ACTION_TABLE_SIZE 32
+#define SOURCE_RING_MASK (SOURCE_RING_SIZE - 1)
+
+typedef struct action_entry_t {
+    const char *word;
+    action_e action;
+} action_entry_t;
+
+/**
+ * @brief Calcula o hash de uma ação: primeiro caractere + último caractere + tamanho.
+ *
+ * Para as 12 ações do jogo esse hash não tem colisões em uma tabela de 32 posições.
+ */
+#define ACTION_HASH(word, length) \
+    (((unsigned char) (word)[0] + (unsigned char) (word)[(length) - 1] + (length)) & (ACTION_TABLE_SIZE - 1))
+
+/**
+ * @brief Tabela hash perfeita das ações, indexada por `ACTION_HASH`.
+ */
+static const action_entry_t action_table[ACTION_TABLE_SIZE] = {
+    [0] = {"vence", ACTION_WIN},
+    [6] = {"pos", ACTION_POSITION},
+    [7] = {"ataca", ACTION_ATTACK},
+    [9] = {"alianca", ACTION_ALLIANCE},
+    [11] = {"caminha", ACTION_WALK},
+    [10] = {"coleta", ACTION_COLLECT},
+    [13] = {"ganha", ACTION_EARN},
+    [15] = {"combate", ACTION_COMBAT},
+    [16] = {"defende", ACTION_DEFEND},
+    [20] = {"constroi", ACTION_BUILD},
+    [22] = {"move", ACTION_MOVE},
+    [26] = {"perde", ACTION_LOSE},
+};
+
+/**
+ * @brief Verifica se um caractere separa tokens.
+ */
+static int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Lê todo o conteúdo restante de um arquivo para um buffer alocado.
+ *
+ * @param source Estrutura que recebe o buffer.
+ * @param file O arquivo.
+ * @param prefix Bytes já lidos do arquivo, que ficam no início do buffer.
+ * @param prefix_length A quantidade de bytes já lidos.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a memória não puder ser alocada.
+ */
+static int load_remaining(source_t *source, FILE *file, const char *prefix, size_t prefix_length) {
+    size_t capacity = 1 << 16;
+    while (capacity <= prefix_length) capacity *= 2;
+    char *buffer = (char *) malloc(capacity);
+    if (buffer == NULL) return 1;
+    memcpy(buffer, prefix, prefix_length);
+
+    size_t length = prefix_length, read;
+    while ((read = fread(buffer + length, 1, capacity - length, file)) > 0) {
+        length += read;
+        if (length == capacity) {
+            char *larger = (char *) realloc(buffer, capacity * 2);
+            if (larger == NULL) {
+                free(buffer);
+                return 1;
+            }
+            buffer = larger;
+            capacity *= 2;
+        }
+    }
+
+    source->data = buffer;
+    source->size = length;
+    source->binary = is_script(source->data, source->size);
+    return 0;
+}
+
+/**
+ * @brief Abre o conteúdo de um arquivo para leitura dos comandos.
+ *
+ * Arquivos regulares são mapeados em memória com `mmap`. Se o mapeamento não for
+ * possível (por exemplo, em um pipe), o conteúdo restante do arquivo é lido para
+ * um buffer alocado. Se o conteúdo começar com SCRIPT_MAGIC, ele é tratado como um
+ * script compilado.
+ *
+ * @param source Estrutura preenchida com o conteúdo do arquivo.
+ * @param file Arquivo previamente aberto em modo de leitura.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se o arquivo não puder ser lido.
+ */
+int open_source(source_t *source, FILE *file) {
+    struct stat info;
+    int fd = fileno(file);
+
+    memset(source, 0, sizeof(source_t));
+
+    if (fd >= 0 && fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void *data = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            madvise(data, (size_t) info.st_size, MADV_SEQUENTIAL);
+            source->data = data;
+            source->size = (size_t) info.st_size;
+            source->pos = (size_t) ftell(file);
+            source->mapped = 1;
+            source->binary = is_script(source->data + source->pos, source->size - source->pos);
+            return 0;
+        }
+    }
+
+    // Alternativa sem mmap: lê todo o conteúdo restante para a memória
+    return load_remaining(source, file, NULL, 0);
+}
+
+/**
+ * @brief Lê do descritor para o espaço livre do buffer circular.
+ *
+ * Antes de uma leitura que vai esperar pelo escritor, chama `on_wait`. Uma leitura
+ * devolve o que já estiver disponível, sem esperar o buffer encher.
+ *
+ * @return Retorna 0 se algum byte foi lido, ou 1 no fim da entrada ou em caso de erro.
+ */
+static int fill_ring(source_t *source) {
+    size_t offset = source->tail & SOURCE_RING_MASK;
+    size_t room = SOURCE_RING_SIZE - (source->tail - source->head);
+    size_t chunk = SOURCE_RING_SIZE - offset;
+    if (chunk > room) chunk = room;
+
+    if (source->on_wait != NULL) {
+        struct pollfd pending = {source->fd, POLLIN, 0};
+        if (poll(&pending, 1, 0) == 0) source->on_wait(source->wait_context);
+    }
+
+    ssize_t got;
+    do {
+        got = read(source->fd, source->ring + offset, chunk);
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0) {
+        source->eof = 1;
+        return 1;
+    }
+    source->tail += (size_t) got;
+    return 0;
+}
+
+/**
+ * @brief Consome do buffer circular os bytes até a posição absoluta `end`.
+ *
+ * @return Os bytes consumidos, contíguos: no próprio buffer ou, se derem a volta no fim
+ *         dele, copiados para `source->line`. Valem até a próxima leitura.
+ */
+static const char *take_line(source_t *source, size_t end, size_t *length) {
+    size_t offset = source->head & SOURCE_RING_MASK;
+    const char *line = source->ring + offset;
+    *length = end - source->head;
+    if (offset + *length > SOURCE_RING_SIZE) {
+        size_t first = SOURCE_RING_SIZE - offset;
+        memcpy(source->line, source->ring + offset, first);
+        memcpy(source->line + first, source->ring, *length - first);
+        line = source->line;
+    }
+    source->head = end;
+    source->scanned = end;
+    return line;
+}
+
+/**
+ * @brief Obtém a próxima linha completa da entrada contínua, lendo mais dados se preciso.
+ *
+ * Uma linha maior que o buffer é entregue truncada em SOURCE_RING_SIZE bytes e o seu
+ * restante é descartado. A última linha da entrada não precisa terminar em '\n'.
+ *
+ * @return Retorna 0 se uma linha foi obtida, ou 1 no fim da entrada.
+ */
+static int next_line(source_t *source, const char **line, size_t *length) {
+    for (;;) {
+        // Procura o fim da linha nos bytes que chegaram desde a última procura
+        const char *newline = NULL;
+        while (newline == NULL && source->scanned < source->tail) {
+            size_t offset = source->scanned & SOURCE_RING_MASK;
+            size_t chunk = source->tail - source->scanned;
+            if (chunk > SOURCE_RING_SIZE - offset) chunk = SOURCE_RING_SIZE - offset;
+            newline = memchr(source->ring + offset, '\n', chunk);
+            source->scanned += newline != NULL ? (size_t) (newline - (source->ring + offset)) + 1 : chunk;
+        }
+
+        size_t used = source->tail - source->head;
+        int complete = newline != NULL;
+        if (!complete && used < SOURCE_RING_SIZE && !(source->eof && used > 0)) {
+            if (source->eof || fill_ring(source) != 0) {
+                if (source->tail == source->head) return 1;
+            }
+            continue;
+        }
+
+        *line = take_line(source, complete ? source->scanned : source->tail, length);
+        if (source->discard) {
+            // Restante de uma linha longa demais
+            if (complete) source->discard = 0;
+            continue;
+        }
+        if (!complete && !source->eof) source->discard = 1;
+        return 0;
+    }
+}
+
+/**
+ * @brief Abre uma entrada para leitura contínua dos comandos, à medida que chegam.
+ *
+ * Pipes, FIFOs e terminais são lidos aos poucos para um buffer circular de
+ * SOURCE_RING_SIZE bytes, com memória constante independente do tamanho da entrada.
+ * Cada `read_command` devolve o próximo comando assim que a sua linha chega inteira,
+ * esperando pelo escritor se necessário. Arquivos regulares são abertos com
+ * `open_source`; um script compilado recebido por pipe é lido inteiro, como em `open_source`.
+ *
+ * @param source Estrutura preenchida para a leitura. Antes de ler os comandos, o chamador
+ *               pode definir `on_wait` (por exemplo, para descarregar o log enquanto
+ *               espera pela entrada).
+ * @param file Arquivo previamente aberto em modo de leitura, do qual nada foi lido ainda.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a entrada não puder ser lida ou a
+ *         memória não puder ser alocada.
+ */
+int open_stream(source_t *source, FILE *file) {
+    struct stat info;
+    int fd = fileno(file);
+    if (fd < 0 || fstat(fd, &info) != 0 || S_ISREG(info.st_mode)) return open_source(source, file);
+
+    memset(source, 0, sizeof(source_t));
+    source->fd = fd;
+    source->ring = (char *) malloc(SOURCE_RING_SIZE);
+    source->line = (char *) malloc(SOURCE_RING_SIZE);
+    if (source->ring == NULL || source->line == NULL) {
+        close_source(source);
+        return 1;
+    }
+    source->streaming = 1;
+
+    // Os scripts compilados não são divididos em linhas: são lidos inteiros
+    while (source->tail < SCRIPT_MAGIC_LEN && fill_ring(source) == 0) continue;
+    if (!is_script(source->ring, source->tail)) return 0;
+
+    int status = load_remaining(source, file, source->ring, source->tail);
+    free(source->ring);
+    free(source->line);
+    source->ring = NULL;
+    source->line = NULL;
+    source->streaming = 0;
+    return status;
+}
+
+/**
+ * @brief Libera o conteúdo aberto com `open_source`.
+ *
+ * @param source O conteúdo a ser liberado.
+ */
+void close_source(source_t *source) {
+    if (source->mapped) {
+        munmap((void *) source->data, source->size);
+    } else {
+        free((void *) source->data);
+    }
+    free(source->ring);
+    free(source->line);
+    source->data = NULL;
+    source->size = 0;
+    source->pos = 0;
+    source->ring = NULL;
+    source->line = NULL;
+    source->streaming = 0;
+}
+
+/**
+ * @brief Converte o nome de uma ação para `action_e`.
+ *
+ * @param word Início do nome da ação (não precisa terminar em '\0').
+ * @param length Tamanho do nome.
+ *
+ * @return A ação correspondente, ou ACTION_UNKNOWN se o nome não for uma ação do jogo.
+ */
+action_e parse_action(const char *word, size_t length) {
+    if (length == 0) return ACTION_UNKNOWN;
+    const action_entry_t *entry = &action_table[ACTION_HASH(word, length)];
+    if (entry->word == NULL || strlen(entry->word) != length || memcmp(entry->word, word, length) != 0) {
+        return ACTION_UNKNOWN;
+    }
+    return entry->action;
+}
+
+/**
+ * @brief Obtém o nome de uma ação, como escrito no arquivo de entrada.
+ *
+ * @param action A ação.
+ * @return O nome da ação, ou "desconhecida" para ACTION_UNKNOWN e valores inválidos.
+ */
+const char *get_action_name(action_e action) {
+    static const char *names[ACTION_LAST + 1] = {
+        [ACTION_UNKNOWN] = "desconhecida",
+        [ACTION_ALLIANCE] = "alianca",
+        [ACTION_ATTACK] = "ataca",
+        [ACTION_COMBAT] = "combate",
+        [ACTION_EARN] = "ganha",
+        [ACTION_LOSE] = "perde",
+        [ACTION_WIN] = "vence",
+        [ACTION_POSITION] = "pos",
+        [ACTION_MOVE] = "move",
+        [ACTION_COLLECT] = "coleta",
+        [ACTION_BUILD] = "constroi",
+        [ACTION_DEFEND] = "defende",
+        [ACTION_WALK] = "caminha",
+    };
+    if ((int) action < 0 || action > ACTION_LAST) return names[ACTION_UNKNOWN];
+    return names[action];
+}
+
+/**
+ * @brief Converte um token para inteiro, se ele for um número decimal.
+ *
+ * @param token Início do token.
+ * @param length Tamanho do token.
+ * @param value Onde o valor será armazenado.
+ *
+ * @return Retorna 1 se o token inteiro for um número que cabe em `int`, ou 0 caso contrário.
+ */
+static int parse_int(const char *token, size_t length, int *value) {
+    size_t i = 0;
+    int negative = 0;
+    if (length > 0 && (token[0] == '-' || token[0] == '+')) {
+        negative = token[0] == '-';
+        i = 1;
+    }
+    if (i == length) return 0;
+
+    // Números fora do intervalo de `int` são recusados como qualquer outro token inválido
+    long long limit = negative ? (long long) INT_MAX + 1 : INT_MAX;
+    long long result = 0;
+    for (; i < length; i++) {
+        if (token[i] < '0' || token[i] > '9') return 0;
+        result = result * 10 + (token[i] - '0');
+        if (result > limit) return 0;
+    }
+    *value = (int) (negative ? -result : result);
+    return 1;
+}
+
+/**
+ * @brief Copia um token para um buffer de nome, truncando se necessário.
+ */
+static void copy_name(char name[COMMAND_NAME_LEN], const char *token, size_t length) {
+    if (length > COMMAND_NAME_LEN - 1) length = COMMAND_NAME_LEN - 1;
+    memcpy(name, token, length);
+    name[length] = '\0';
+}
+
+/**
+ * @brief Avança até o próximo token, sem atravessar o fim da linha se `same_line` for 1.
+ *
+ * @return O tamanho do token encontrado, ou 0 se não houver mais tokens.
+ */
+static size_t next_token(source_t *source, int same_line, const char **token) {
+    while (source->pos < source->size && is_space(source->data[source->pos])) {
+        if (same_line && source->data[source->pos] == '\n') return 0;
+        source->pos++;
+    }
+    size_t start = source->pos;
+    while (source->pos < source->size && !is_space(source->data[source->pos])) source->pos++;
+    *token = source->data + start;
+    return source->pos - start;
+}
+
+/**
+ * @brief Lê o cabeçalho de uma entrada contínua, linha a linha (veja `read_header`).
+ */
+static int read_stream_header(source_t *source, int *rows, int *columns, int *num_factions) {
+    int *values[3] = {rows, columns, num_factions};
+    int count = 0;
+    while (count < 3) {
+        source_t line = {0};
+        if (next_line(source, &line.data, &line.size) != 0) return count < 2 ? 1 : 2;
+
+        const char *token;
+        size_t length;
+        while (count < 3 && (length = next_token(&line, 0, &token)) > 0) {
+            if (!parse_int(token, length, values[count])) return count < 2 ? 1 : 2;
+            count++;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Lê o cabeçalho do arquivo: as dimensões do tabuleiro e o número de facções.
+ *
+ * @param source Conteúdo aberto com `open_source` ou `open_stream`.
+ * @param rows Onde o número de linhas será armazenado.
+ * @param columns Onde o número de colunas será armazenado.
+ * @param num_factions Onde o número de facções será armazenado.
+ *
+ * @return Retorna 0 se o cabeçalho foi lido com sucesso, 1 se as dimensões não puderem
+ *         ser lidas e 2 se o número de facções não puder ser lido.
+ */
+int read_header(source_t *source, int *rows, int *columns, int *num_factions) {
+    if (source->binary) return read_script_header(source, rows, columns, num_factions);
+    if (source->streaming) return read_stream_header(source, rows, columns, num_factions);
+
+    const char *token;
+    size_t length;
+
+    length = next_token(source, 0, &token);
+    if (!parse_int(token, length, rows)) return 1;
+    length = next_token(source, 0, &token);
+    if (!parse_int(token, length, columns)) return 1;
+    length = next_token(source, 0, &token);
+    if (!parse_int(token, length, num_factions)) return 2;
+    return 0;
+}
+
+/**
+ * @brief Analisa o próximo comando do texto a partir de `source->pos` (veja `read_command`).
+ */
+static int parse_command(source_t *source, command_t *command) {
+    const char *token;
+    size_t length = next_token(source, 0, &token);
+    if (length == 0) return 1;
+
+    copy_name(command->part, token, length);
+    command->name[0] = '\0';
+    command->param_count = 0;
+
+    length = next_token(source, 1, &token);
+    command->action = parse_action(token, length);
+
+    while ((length = next_token(source, 1, &token)) > 0) {
+        int value;
+        if (parse_int(token, length, &value)) {
+            if (command->param_count < COMMAND_MAX_PARAMS) command->params[command->param_count++] = value;
+        } else if (command->name[0] == '\0') {
+            copy_name(command->name, token, length);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Lê o próximo comando de uma entrada contínua, esperando a sua linha chegar inteira.
+ */
+static int read_stream_command(source_t *source, command_t *command) {
+    for (;;) {
+        source_t line = {0};
+        if (next_line(source, &line.data, &line.size) != 0) return 1;
+        // Linhas em branco não são comandos
+        if (parse_command(&line, command) == 0) return 0;
+    }
+}
+
+/**
+ * @brief Lê o próximo comando do arquivo.
+ *
+ * Cada linha não vazia é um comando no formato `<parte> <ação> [parâmetros...]`. Os
+ * parâmetros numéricos são guardados em `params`, na ordem em que aparecem, e o primeiro
+ * parâmetro não numérico é guardado em `name`. Parâmetros além de COMMAND_MAX_PARAMS
+ * são ignorados.
+ *
+ * @param source Conteúdo aberto com `open_source` ou `open_stream`.
+ * @param command Registro preenchido com o comando lido.
+ *
+ * @return Retorna 0 se um comando foi lido, ou 1 se não houver mais comandos.
+ */
+int read_command(source_t *source, command_t *command) {
+    if (source->binary) return read_script_command(source, command);
+    if (source->streaming) return read_stream_command(source, command);
+    return parse_command(source, command);
+}
+
+/**
+ * @brief Lê todos os comandos restantes para um array.
+ *
+ * Usada quando a mesma lista de comandos é aplicada várias vezes (por exemplo, nas
+ * simulações de Monte Carlo), para que o arquivo seja analisado uma única vez.
+ *
+ * @param source Conteúdo aberto com `open_source`, já com o cabeçalho lido.
+ * @param commands Onde será guardado o array alocado com os comandos. Deve ser liberado com `free`.
+ * @param count Onde será guardada a quantidade de comandos lidos.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a memória não puder ser alocada.
+ */
+int read_all_commands(source_t *source, command_t **commands, size_t *count) {
+    size_t capacity = 64;
+    *count = 0;
+    *commands = (command_t *) malloc(capacity * sizeof(command_t));
+    if (*commands == NULL) return 1;
+
+    command_t command;
+    while (read_command(source, &command) == 0) {
+        if (*count == capacity) {
+            command_t *grown = (command_t *) realloc(*commands, 2 * capacity * sizeof(command_t));
+            if (grown == NULL) {
+                free(*commands);
+                *commands = NULL;
+                *count = 0;
+                return 1;
+            }
+            *commands = grown;
+            capacity *= 2;
+        }
+        (*commands)[(*count)++] = command;
+    }
+    return 0;
+}
@@ -0,0 +1,313 @@
+/**
+ * @file path.c
+ * @brief Busca de caminhos sobre o mapa de terrenos.
+ *
+ * Entrar em uma célula custa de acordo com o seu terreno (planície 1, floresta 2,
+ * montanha 3), e as unidades andam nas quatro direções. `find_path` calcula o caminho
+ * de menor custo entre duas células com A* (heurística: distância de Manhattan, que
+ * nunca superestima, pois o menor custo de um passo é 1). Para muitas unidades indo
+ * para o mesmo alvo, `build_flow_field` calcula de uma vez (Dijkstra a partir do alvo)
+ * o custo de cada célula até ele, e cada unidade só precisa descer esse campo com
+ * `follow_flow_field`. O campo é guardado e reaproveitado enquanto o alvo não mudar.
+ *
+ * Todos os buffers ficam no `pathfinder_t` e são alocados uma única vez. Em vez de
+ * limpar os custos a cada busca, cada célula guarda o número da busca em que foi
+ * escrita, e células de buscas anteriores valem como não visitadas.
+ */
+
+#include "path.h"
+
+static const int terrain_costs[4] = {
+    [PLANICE] = 1,
+    [FLORESTA] = 2,
+    [MONTANHA] = 3,
+    [TERRAIN_NONE] = PATH_UNREACHABLE,
+};
+
+/**
+ * @brief Aloca os buffers na primeira busca.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar.
+ */
+static int reserve_pathfinder(pathfinder_t *pathfinder) {
+    if (pathfinder->cost != NULL) return 0;
+
+    size_t cells = (size_t) pathfinder->lines * pathfinder->columns;
+    if (cells == 0) return 1;
+    // Sem decremento de chave, cada célula entra na fila no máximo uma vez por vizinho, mais a origem
+    size_t heap_capacity = 4 * cells + 1;
+
+    pathfinder->cost = malloc(cells * sizeof(int));
+    pathfinder->parent = malloc(cells * sizeof(int));
+    pathfinder->stamp = calloc(cells, sizeof(unsigned int));
+    pathfinder->heap_cell = malloc(heap_capacity * sizeof(int));
+    pathfinder->heap_key = malloc(heap_capacity * sizeof(int));
+    pathfinder->path = malloc(cells * sizeof(int));
+    pathfinder->field = malloc(cells * sizeof(int));
+    if (pathfinder->cost == NULL || pathfinder->parent == NULL || pathfinder->stamp == NULL || pathfinder->heap_cell == NULL ||
+        pathfinder->heap_key == NULL || pathfinder->path == NULL || pathfinder->field == NULL) {
+        int lines = pathfinder->lines, columns = pathfinder->columns;
+        free_pathfinder(pathfinder);
+        init_pathfinder(pathfinder, lines, columns);
+        return 1;
+    }
+    pathfinder->heap_capacity = (int) heap_capacity;
+    return 0;
+}
+
+/**
+ * @brief Insere uma célula na fila de prioridade.
+ */
+static void push_heap(pathfinder_t *pathfinder, int cell, int key) {
+    int i = pathfinder->heap_count++;
+    while (i > 0) {
+        int up = (i - 1) / 2;
+        if (pathfinder->heap_key[up] <= key) break;
+        pathfinder->heap_cell[i] = pathfinder->heap_cell[up];
+        pathfinder->heap_key[i] = pathfinder->heap_key[up];
+        i = up;
+    }
+    pathfinder->heap_cell[i] = cell;
+    pathfinder->heap_key[i] = key;
+}
+
+/**
+ * @brief Retira a célula de menor chave da fila de prioridade.
+ */
+static int pop_heap(pathfinder_t *pathfinder, int *key) {
+    int cell = pathfinder->heap_cell[0];
+    *key = pathfinder->heap_key[0];
+
+    int last_cell = pathfinder->heap_cell[--pathfinder->heap_count];
+    int last_key = pathfinder->heap_key[pathfinder->heap_count];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= pathfinder->heap_count) break;
+        if (child + 1 < pathfinder->heap_count && pathfinder->heap_key[child + 1] < pathfinder->heap_key[child]) child++;
+        if (pathfinder->heap_key[child] >= last_key) break;
+        pathfinder->heap_cell[i] = pathfinder->heap_cell[child];
+        pathfinder->heap_key[i] = pathfinder->heap_key[child];
+        i = child;
+    }
+    pathfinder->heap_cell[i] = last_cell;
+    pathfinder->heap_key[i] = last_key;
+    return cell;
+}
+
+/**
+ * @brief Lista as células vizinhas (acima, abaixo, à esquerda e à direita) dentro do tabuleiro.
+ *
+ * @return A quantidade de vizinhos escritos em `neighbors`.
+ */
+static int list_neighbors(const pathfinder_t *pathfinder, int cell, int neighbors[4]) {
+    int line = cell / pathfinder->columns, col = cell % pathfinder->columns;
+    int count = 0;
+    if (line > 0) neighbors[count++] = cell - pathfinder->columns;
+    if (line + 1 < pathfinder->lines) neighbors[count++] = cell + pathfinder->columns;
+    if (col > 0) neighbors[count++] = cell - 1;
+    if (col + 1 < pathfinder->columns) neighbors[count++] = cell + 1;
+    return count;
+}
+
+/**
+ * @brief Inicializa os buffers de busca de um tabuleiro, sem alocar nada.
+ *
+ * @param pathfinder Os buffers a serem inicializados.
+ * @param lines O número de linhas do tabuleiro.
+ * @param columns O número de colunas do tabuleiro.
+ */
+void init_pathfinder(pathfinder_t *pathfinder, int lines, int columns) {
+    memset(pathfinder, 0, sizeof(pathfinder_t));
+    pathfinder->lines = lines;
+    pathfinder->columns = columns;
+    pathfinder->field_target = PATH_NO_TARGET;
+}
+
+/**
+ * @brief Calcula o custo de entrar em uma célula.
+ *
+ * @param terrain O mapa de terrenos.
+ * @param line A linha da célula.
+ * @param col A coluna da célula.
+ * @return O custo do terreno da célula, ou PATH_UNREACHABLE se ela estiver fora do mapa.
+ */
+int step_cost(const terrain_t *terrain, int line, int col) {
+    return terrain_costs[get_terrain(terrain, line, col)];
+}
+
+/**
+ * @brief Calcula o caminho de menor custo entre duas células com A*.
+ *
+ * O caminho fica em `pathfinder->path` (índices `line * columns + col`, sem a célula de
+ * origem e com a de destino), com `pathfinder->path_length` células.
+ *
+ * @param pathfinder Os buffers de busca, com as mesmas dimensões do mapa.
+ * @param terrain O mapa de terrenos.
+ * @param from_line A linha de origem.
+ * @param from_col A coluna de origem.
+ * @param to_line A linha de destino.
+ * @param to_col A coluna de destino.
+ * @return O custo do caminho, ou PATH_UNREACHABLE se a origem ou o destino estiverem
+ *         fora do mapa ou a memória não puder ser alocada.
+ */
+int find_path(pathfinder_t *pathfinder, const terrain_t *terrain, int from_line, int from_col, int to_line, int to_col) {
+    pathfinder->path_length = 0;
+    if (get_terrain(terrain, from_line, from_col) == TERRAIN_NONE || get_terrain(terrain, to_line, to_col) == TERRAIN_NONE) {
+        return PATH_UNREACHABLE;
+    }
+    if (reserve_pathfinder(pathfinder) != 0) return PATH_UNREACHABLE;
+
+    // Uma nova busca invalida os custos de todas as anteriores
+    if (++pathfinder->generation == 0) {
+        memset(pathfinder->stamp, 0, (size_t) pathfinder->lines * pathfinder->columns * sizeof(unsigned int));
+        pathfinder->generation = 1;
+    }
+    unsigned int generation = pathfinder->generation;
+    int columns = pathfinder->columns;
+    int start = from_line * columns + from_col;
+    int goal = to_line * columns + to_col;
+
+    pathfinder->cost[start] = 0;
+    pathfinder->parent[start] = -1;
+    pathfinder->stamp[start] = generation;
+    pathfinder->heap_count = 0;
+    push_heap(pathfinder, start, abs(from_line - to_line) + abs(from_col - to_col));
+
+    while (pathfinder->heap_count > 0) {
+        int key;
+        int cell = pop_heap(pathfinder, &key);
+        if (cell == goal) break;
+
+        int line = cell / columns, col = cell % columns;
+        // Entradas antigas de células que já foram melhoradas são ignoradas
+        if (key != pathfinder->cost[cell] + abs(line - to_line) + abs(col - to_col)) continue;
+
+        int neighbors[4];
+        int count = list_neighbors(pathfinder, cell, neighbors);
+        for (int i = 0; i < count; i++) {
+            int next = neighbors[i];
+            int next_line = next / columns, next_col = next % columns;
+            int cost = pathfinder->cost[cell] + terrain_costs[terrain->cells[next]];
+            if (pathfinder->stamp[next] == generation && cost >= pathfinder->cost[next]) continue;
+
+            pathfinder->cost[next] = cost;
+            pathfinder->parent[next] = cell;
+            pathfinder->stamp[next] = generation;
+            push_heap(pathfinder, next, cost + abs(next_line - to_line) + abs(next_col - to_col));
+        }
+    }
+
+    // O mapa não tem obstáculos, então o destino sempre é alcançado
+    int length = 0;
+    for (int cell = goal; cell != start; cell = pathfinder->parent[cell]) length++;
+    pathfinder->path_length = length;
+    for (int cell = goal; cell != start; cell = pathfinder->parent[cell]) pathfinder->path[--length] = cell;
+    return pathfinder->cost[goal];
+}
+
+/**
+ * @brief Calcula o custo de cada célula do mapa até uma célula alvo (campo de fluxo).
+ *
+ * Se o campo do mesmo alvo já tiver sido calculado, nada é refeito.
+ *
+ * @param pathfinder Os buffers de busca, com as mesmas dimensões do mapa.
+ * @param terrain O mapa de terrenos.
+ * @param to_line A linha do alvo.
+ * @param to_col A coluna do alvo.
+ * @return Retorna 0 em caso de sucesso, ou 1 se o alvo estiver fora do mapa ou a
+ *         memória não puder ser alocada.
+ */
+int build_flow_field(pathfinder_t *pathfinder, const terrain_t *terrain, int to_line, int to_col) {
+    if (get_terrain(terrain, to_line, to_col) == TERRAIN_NONE) return 1;
+    if (reserve_pathfinder(pathfinder) != 0) return 1;
+
+    int columns = pathfinder->columns;
+    int target = to_line * columns + to_col;
+    if (pathfinder->field_target == target) return 0;
+
+    int *field = pathfinder->field;
+    size_t cells = (size_t) pathfinder->lines * columns;
+    for (size_t i = 0; i < cells; i++) field[i] = PATH_UNREACHABLE;
+
+    // Dijkstra a partir do alvo: ir de uma célula para a vizinha custa o terreno da vizinha
+    field[target] = 0;
+    pathfinder->heap_count = 0;
+    push_heap(pathfinder, target, 0);
+    while (pathfinder->heap_count > 0) {
+        int key;
+        int cell = pop_heap(pathfinder, &key);
+        if (key != field[cell]) continue;
+
+        int cost = key + terrain_costs[terrain->cells[cell]];
+        int neighbors[4];
+        int count = list_neighbors(pathfinder, cell, neighbors);
+        for (int i = 0; i < count; i++) {
+            if (cost < field[neighbors[i]]) {
+                field[neighbors[i]] = cost;
+                push_heap(pathfinder, neighbors[i], cost);
+            }
+        }
+    }
+    pathfinder->field_target = target;
+    return 0;
+}
+
+/**
+ * @brief Anda a partir de uma célula, descendo o último campo de fluxo calculado.
+ *
+ * @param pathfinder Os buffers de busca, com um campo calculado por `build_flow_field`.
+ * @param terrain O mapa de terrenos usado no campo.
+ * @param line A linha de origem; recebe a linha onde a caminhada parou.
+ * @param col A coluna de origem; recebe a coluna onde a caminhada parou.
+ * @param budget O custo máximo da caminhada, ou um valor negativo para ir até o alvo.
+ * @param steps Onde será guardado o número de passos dados.
+ * @return O custo da caminhada.
+ */
+int follow_flow_field(const pathfinder_t *pathfinder, const terrain_t *terrain, int *line, int *col, int budget, int *steps) {
+    *steps = 0;
+    if (pathfinder->field_target == PATH_NO_TARGET || get_terrain(terrain, *line, *col) == TERRAIN_NONE) return 0;
+
+    const int *field = pathfinder->field;
+    int cell = *line * pathfinder->columns + *col;
+    int spent = 0;
+    while (field[cell] > 0) {
+        // O próximo passo é o vizinho por onde o custo até o alvo diminui exatamente o custo do passo
+        int neighbors[4];
+        int count = list_neighbors(pathfinder, cell, neighbors);
+        int next = -1, next_cost = 0;
+        for (int i = 0; i < count; i++) {
+            int cost = terrain_costs[terrain->cells[neighbors[i]]];
+            if (field[neighbors[i]] != PATH_UNREACHABLE && field[neighbors[i]] + cost == field[cell]) {
+                next = neighbors[i];
+                next_cost = cost;
+                break;
+            }
+        }
+        if (next < 0 || (budget >= 0 && spent + next_cost > budget)) break;
+        spent += next_cost;
+        cell = next;
+        (*steps)++;
+    }
+
+    *line = cell / pathfinder->columns;
+    *col = cell % pathfinder->columns;
+    return spent;
+}
+
+/**
+ * @brief Libera os buffers de busca.
+ *
+ * @param pathfinder Os buffers a serem liberados. Podem ser reutilizados após `init_pathfinder`.
+ */
+void free_pathfinder(pathfinder_t *pathfinder) {
+    free(pathfinder->cost);
+    free(pathfinder->parent);
+    free(pathfinder->stamp);
+    free(pathfinder->heap_cell);
+    free(pathfinder->heap_key);
+    free(pathfinder->path);
+    free(pathfinder->field);
+    memset(pathfinder, 0, sizeof(pathfinder_t));
+    pathfinder->field_target = PATH_NO_TARGET;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file pool.c
+ * @brief Alocador em blocos para os objetos de tamanho fixo do jogo.
+ *
+ * Unidades, facções, prédios e alianças são criados e destruídos com frequência
+ * durante uma partida. Em vez de um `malloc` e um `free` por objeto, cada tipo
+ * possui um pool que reserva blocos (slabs) de objetos de uma só vez, cada bloco
+ * com o dobro do tamanho do anterior. Objetos liberados voltam para uma lista de
+ * livres e são reaproveitados pela próxima alocação do mesmo tipo.
+ *
+ * Os blocos vivem enquanto a thread tiver partidas: `end_game` devolve os objetos de
+ * uma partida aos pools e `release_pools` devolve todos os blocos ao sistema de uma
+ * só vez. Cada thread
+ * possui os seus próprios pools, portanto nenhuma sincronização é necessária.
+ */
+
+#include "pool.h"
+
+#define POOL_FIRST_SLAB 64        // Objetos no primeiro bloco de cada pool
+#define POOL_MAX_SLAB 65536       // Limite de objetos por bloco
+
+typedef struct slab_t {
+    struct slab_t *next;
+    size_t count;                 // Objetos que cabem neste bloco
+    size_t used;                  // Objetos já entregues a partir deste bloco
+    max_align_t data[];
+} slab_t;
+
+typedef struct pool_t {
+    size_t object_size;
+    size_t slab_count;
+    size_t capacity;
+    size_t live;
+    slab_t *slabs;                // Bloco mais recente primeiro
+    void *free_list;              // Objetos liberados, encadeados pelo primeiro ponteiro
+} pool_t;
+
+static const char *pool_names[POOL_COUNT] = {"unit_t", "faction_t", "building_t", "alliance_t"};
+
+static _Thread_local pool_t pools[POOL_COUNT];
+
+/**
+ * @brief Arredonda o tamanho de um objeto para o alinhamento máximo da plataforma.
+ *
+ * @param size O tamanho do objeto.
+ * @return O tamanho alinhado, nunca menor que um ponteiro.
+ */
+static size_t align_size(size_t size) {
+    size_t align = _Alignof(max_align_t);
+    if (size < sizeof(void *)) size = sizeof(void *);
+    return (size + align - 1) / align * align;
+}
+
+/**
+ * @brief Aloca um objeto de um pool.
+ *
+ * O objeto é retirado da lista de livres, ou do bloco mais recente. Se nenhum
+ * dos dois tiver espaço, um novo bloco, com o dobro de objetos do anterior, é alocado.
+ *
+ * @param pool O pool do tipo do objeto.
+ * @param size O tamanho do objeto. Deve ser sempre o mesmo para um mesmo pool.
+ * @return Um ponteiro para o objeto, não inicializado, ou NULL se a alocação falhar.
+ */
+void *pool_alloc(pool_e pool, size_t size) {
+    pool_t *current = &pools[pool];
+    if (current->object_size == 0) current->object_size = align_size(size);
+
+    if (current->free_list != NULL) {
+        void *object = current->free_list;
+        current->free_list = *(void **) object;
+        current->live++;
+        return object;
+    }
+
+    slab_t *slab = current->slabs;
+    if (slab == NULL || slab->used == slab->count) {
+        size_t count = slab == NULL ? POOL_FIRST_SLAB : slab->count * 2;
+        if (count > POOL_MAX_SLAB) count = POOL_MAX_SLAB;
+
+        slab = (slab_t *) malloc(sizeof(slab_t) + count * current->object_size);
+        if (slab == NULL) return NULL;
+        slab->count = count;
+        slab->used = 0;
+        slab->next = current->slabs;
+        current->slabs = slab;
+        current->slab_count++;
+        current->capacity += count;
+    }
+
+    void *object = (char *) slab->data + slab->used * current->object_size;
+    slab->used++;
+    current->live++;
+    return object;
+}
+
+/**
+ * @brief Devolve um objeto ao seu pool.
+ *
+ * A memória não é liberada: o objeto passa para a lista de livres e é reaproveitado
+ * pela próxima alocação do mesmo pool.
+ *
+ * @param pool O pool de onde o objeto foi alocado.
+ * @param object O objeto a ser devolvido. Se for NULL, nada acontece.
+ */
+void pool_free(pool_e pool, void *object) {
+    if (object == NULL) return;
+    pool_t *current = &pools[pool];
+    *(void **) object = current->free_list;
+    current->free_list = object;
+    current->live--;
+}
+
+/**
+ * @brief Obtém os contadores de um pool da thread atual.
+ *
+ * @param pool O pool consultado.
+ * @param stats Estrutura preenchida com os contadores do pool.
+ */
+void pool_stats(pool_e pool, pool_stats_t *stats) {
+    const pool_t *current = &pools[pool];
+    stats->name = pool_names[pool];
+    stats->object_size = current->object_size;
+    stats->live = current->live;
+    stats->capacity = current->capacity;
+    stats->live_bytes = current->live * current->object_size;
+    stats->reserved_bytes = current->capacity * current->object_size + current->slab_count * sizeof(slab_t);
+    stats->slabs = current->slab_count;
+}
+
+/**
+ * @brief Imprime uma tabela com os contadores de todos os pools da thread atual.
+ *
+ * @param out Arquivo onde a tabela será impressa.
+ */
+void print_pool_stats(FILE *out) {
+    fprintf(out, "=== Pools de memória ===\n");
+    fprintf(out, "%-12s %8s %10s %12s %14s %8s\n", "tipo", "vivos", "capacidade", "bytes vivos", "bytes reserv.", "blocos");
+    for (int i = 0; i < POOL_COUNT; i++) {
+        pool_stats_t stats;
+        pool_stats((pool_e) i, &stats);
+        fprintf(out, "%-12s %8zu %10zu %12zu %14zu %8zu\n",
+                stats.name, stats.live, stats.capacity, stats.live_bytes, stats.reserved_bytes, stats.slabs);
+    }
+}
+
+/**
+ * @brief Libera todos os blocos de todos os pools da thread atual.
+ *
+ * Todos os objetos alocados pelos pools deixam de ser válidos, inclusive os que
+ * ainda estiverem em listas do jogo. É a forma de encerrar uma partida de uma vez,
+ * em vez de liberar cada lista separadamente.
+ */
+void release_pools(void) {
+    for (int i = 0; i < POOL_COUNT; i++) {
+        slab_t *slab = pools[i].slabs;
+        while (slab != NULL) {
+            slab_t *next = slab->next;
+            free(slab);
+            slab = next;
+        }
+        pools[i].slabs = NULL;
+        pools[i].free_list = NULL;
+        pools[i].slab_count = 0;
+        pools[i].capacity = 0;
+        pools[i].live = 0;
+    }
+}
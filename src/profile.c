@@ -0,0 +1,183 @@
+/**
+ * @file profile.c
+ * @brief Medição do tempo gasto em cada ação, na impressão do tabuleiro e no log.
+ *
+ * Compilado com `-DPROFILE` (`make PROFILE=1`), o jogo mede cada comando aplicado por
+ * `apply_command`, cada `print_board` e cada escrita no log com o relógio monotônico e
+ * acumula, por medição, o número de chamadas, o tempo total e o máximo. Os tempos vão
+ * para um histograma log-linear (8 faixas por potência de 2, erro relativo de no máximo
+ * 12,5%), de onde saem os percentis sem guardar cada amostra. Sem PROFILE, as macros
+ * de profile.h não geram código e só `parse_profile_format` é compilada.
+ *
+ * Os contadores são locais à thread, como os pools: cada thread mede as suas partidas
+ * sem travas, e `print_profile` mostra apenas os da thread que a chama.
+ */
+
+#include "profile.h"
+
+#include <string.h>
+
+/**
+ * @brief Converte o nome de um formato de perfil (`tabela` ou `json`).
+ *
+ * @param name O nome do formato.
+ * @param format Onde o formato será escrito.
+ * @return Retorna 0 em caso de sucesso, ou 1 se o nome não for reconhecido.
+ */
+int parse_profile_format(const char *name, profile_format_e *format) {
+    if (strcmp(name, "tabela") == 0) {
+        *format = PROFILE_TABLE;
+        return 0;
+    }
+    if (strcmp(name, "json") == 0) {
+        *format = PROFILE_JSON;
+        return 0;
+    }
+    return 1;
+}
+
+#ifdef PROFILE
+
+#define PROFILE_SUB_BITS 3                                  // 8 faixas por potência de 2
+#define PROFILE_LINEAR (2 << PROFILE_SUB_BITS)              // Valores abaixo disto têm faixa própria
+#define PROFILE_BUCKETS (PROFILE_LINEAR + (64 - PROFILE_SUB_BITS - 1) * (1 << PROFILE_SUB_BITS))
+
+typedef struct profile_counter_t {
+    uint64_t calls;
+    uint64_t total;                     // Nanossegundos somados
+    uint64_t max;
+    uint64_t buckets[PROFILE_BUCKETS];  // Histograma log-linear dos tempos
+} profile_counter_t;
+
+static _Thread_local profile_counter_t counters[PROFILE_SLOT_COUNT];
+static _Thread_local int profile_paused;
+
+/**
+ * @brief Calcula a faixa do histograma de um tempo.
+ */
+static int bucket_of(uint64_t value) {
+    if (value < PROFILE_LINEAR) return (int) value;
+    int exponent = 63 - __builtin_clzll(value);
+    int sub = (int) (value >> (exponent - PROFILE_SUB_BITS)) & ((1 << PROFILE_SUB_BITS) - 1);
+    return PROFILE_LINEAR + (exponent - PROFILE_SUB_BITS - 1) * (1 << PROFILE_SUB_BITS) + sub;
+}
+
+/**
+ * @brief Calcula o menor tempo de uma faixa do histograma.
+ */
+static uint64_t bucket_floor(int bucket) {
+    if (bucket < PROFILE_LINEAR) return (uint64_t) bucket;
+    int offset = bucket - PROFILE_LINEAR;
+    int exponent = offset / (1 << PROFILE_SUB_BITS) + PROFILE_SUB_BITS + 1;
+    uint64_t sub = (uint64_t) (offset % (1 << PROFILE_SUB_BITS));
+    return ((uint64_t) 1 << exponent) + (sub << (exponent - PROFILE_SUB_BITS));
+}
+
+/**
+ * @brief Registra uma medição.
+ *
+ * @param slot A medição: uma `action_e` ou uma `profile_slot_e`.
+ * @param elapsed O tempo decorrido, em nanossegundos.
+ */
+void record_profile(int slot, uint64_t elapsed) {
+    if (profile_paused) return;
+    profile_counter_t *counter = &counters[slot];
+    counter->calls++;
+    counter->total += elapsed;
+    if (elapsed > counter->max) counter->max = elapsed;
+    counter->buckets[bucket_of(elapsed)]++;
+}
+
+/**
+ * @brief Suspende ou retoma as medições da thread atual.
+ *
+ * A busca da IA (veja ai.c) aplica comandos em cópias da partida; com as medições
+ * suspensas, eles não se misturam aos comandos da partida medida.
+ *
+ * @param paused Se diferente de 0, as medições seguintes são descartadas.
+ * @return O estado anterior, para ser restaurado depois.
+ */
+int pause_profile(int paused) {
+    int previous = profile_paused;
+    profile_paused = paused;
+    return previous;
+}
+
+/**
+ * @brief Estima um percentil pelo histograma, devolvendo o meio da faixa em que ele cai.
+ */
+static uint64_t percentile(const profile_counter_t *counter, double fraction) {
+    uint64_t rank = (uint64_t) (fraction * (double) counter->calls);
+    if (rank >= counter->calls) rank = counter->calls - 1;
+
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < PROFILE_BUCKETS; bucket++) {
+        seen += counter->buckets[bucket];
+        if (seen > rank) {
+            uint64_t low = bucket_floor(bucket);
+            uint64_t high = bucket + 1 < PROFILE_BUCKETS ? bucket_floor(bucket + 1) : counter->max;
+            uint64_t middle = low + (high - low) / 2;
+            return middle < counter->max ? middle : counter->max;
+        }
+    }
+    return counter->max;
+}
+
+/**
+ * @brief Devolve o nome de uma medição.
+ */
+static const char *slot_name(int slot) {
+    if (slot == PROFILE_BOARD) return "tabuleiro";
+    if (slot == PROFILE_LOG) return "log";
+    return get_action_name((action_e) slot);
+}
+
+/**
+ * @brief Imprime as medições da thread atual, omitindo as que não foram chamadas.
+ *
+ * @param out O arquivo de destino.
+ * @param format O formato: tabela ou JSON.
+ */
+void print_profile(FILE *out, profile_format_e format) {
+    if (format == PROFILE_JSON) {
+        fprintf(out, "{\"medicoes\": [");
+    } else {
+        fprintf(out, "=== Perfil ===\n");
+        // Os títulos com acentos têm bytes a mais que colunas; as larguras compensam
+        fprintf(out, "%-14s %10s %12s %11s %10s %10s %10s %11s\n",
+                "medição", "chamadas", "total (ms)", "média (ns)", "p50 (ns)", "p90 (ns)", "p99 (ns)", "máx (ns)");
+    }
+
+    int first = 1;
+    for (int slot = 0; slot < PROFILE_SLOT_COUNT; slot++) {
+        const profile_counter_t *counter = &counters[slot];
+        if (counter->calls == 0) continue;
+
+        uint64_t mean = counter->total / counter->calls;
+        uint64_t p50 = percentile(counter, 0.50), p90 = percentile(counter, 0.90), p99 = percentile(counter, 0.99);
+        if (format == PROFILE_JSON) {
+            fprintf(out, "%s\n  {\"nome\": \"%s\", \"chamadas\": %llu, \"total_ns\": %llu, \"media_ns\": %llu, "
+                         "\"p50_ns\": %llu, \"p90_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu}",
+                    first ? "" : ",", slot_name(slot), (unsigned long long) counter->calls,
+                    (unsigned long long) counter->total, (unsigned long long) mean, (unsigned long long) p50,
+                    (unsigned long long) p90, (unsigned long long) p99, (unsigned long long) counter->max);
+        } else {
+            fprintf(out, "%-12s %10llu %12.3f %10llu %10llu %10llu %10llu %10llu\n",
+                    slot_name(slot), (unsigned long long) counter->calls, counter->total / 1e6,
+                    (unsigned long long) mean, (unsigned long long) p50, (unsigned long long) p90,
+                    (unsigned long long) p99, (unsigned long long) counter->max);
+        }
+        first = 0;
+    }
+
+    if (format == PROFILE_JSON) fprintf(out, "\n]}\n");
+}
+
+/**
+ * @brief Zera as medições da thread atual.
+ */
+void reset_profile(void) {
+    memset(counters, 0, sizeof(counters));
+}
+
+#endif // PROFILE
@@ -0,0 +1,136 @@
+/**
+ * @file rng.c
+ * @brief Gerador de números pseudoaleatórios com semente explícita (xoshiro256**).
+ *
+ * Cada partida carrega o seu próprio `rng_t`, em vez de usar o estado global de
+ * `rand()`: a mesma semente produz sempre a mesma partida, e geradores diferentes
+ * podem ser usados em threads diferentes sem nenhuma sincronização.
+ *
+ * Para execuções em paralelo, `jump_rng` avança o gerador 2^128 passos e
+ * `long_jump_rng` avança 2^192 passos. `stream_rng` usa os dois para derivar, de uma
+ * única semente, uma sequência independente para cada simulação e cada thread, de
+ * forma que o resultado de cada uma não depende da ordem em que são executadas.
+ */
+
+#include "rng.h"
+
+/**
+ * @brief Rotaciona um inteiro de 64 bits para a esquerda.
+ */
+static inline uint64_t rotate_left(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/**
+ * @brief Aplica ao gerador um polinômio de salto do xoshiro256**.
+ */
+static void apply_jump(rng_t *rng, const uint64_t jump[4]) {
+    uint64_t state[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jump[i] & ((uint64_t) 1 << b)) {
+                state[0] ^= rng->state[0];
+                state[1] ^= rng->state[1];
+                state[2] ^= rng->state[2];
+                state[3] ^= rng->state[3];
+            }
+            next_rng(rng);
+        }
+    }
+    rng->state[0] = state[0];
+    rng->state[1] = state[1];
+    rng->state[2] = state[2];
+    rng->state[3] = state[3];
+}
+
+/**
+ * @brief Inicializa o gerador a partir de uma semente.
+ *
+ * O estado de 256 bits é preenchido com splitmix64, como recomendado pelos autores do
+ * xoshiro, de modo que sementes próximas produzem sequências sem relação entre si.
+ *
+ * @param rng O gerador a ser inicializado.
+ * @param seed A semente.
+ */
+void seed_rng(rng_t *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        rng->state[i] = z ^ (z >> 31);
+    }
+}
+
+/**
+ * @brief Inicializa o gerador de uma thread de uma simulação.
+ *
+ * A simulação `simulation` começa `simulation` saltos longos (2^192 passos) depois da
+ * semente, e a thread `thread` dessa simulação mais `thread` saltos (2^128 passos).
+ *
+ * @param rng O gerador a ser inicializado.
+ * @param seed A semente comum a todas as simulações.
+ * @param simulation O número da simulação, a partir de 0.
+ * @param thread O número da thread dentro da simulação, a partir de 0.
+ */
+void stream_rng(rng_t *rng, uint64_t seed, int simulation, int thread) {
+    seed_rng(rng, seed);
+    for (int i = 0; i < simulation; i++) long_jump_rng(rng);
+    for (int i = 0; i < thread; i++) jump_rng(rng);
+}
+
+/**
+ * @brief Gera o próximo número de 64 bits da sequência.
+ *
+ * @param rng O gerador.
+ * @return O número gerado.
+ */
+uint64_t next_rng(rng_t *rng) {
+    uint64_t *s = rng->state;
+    uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate_left(s[3], 45);
+    return result;
+}
+
+/**
+ * @brief Gera um inteiro no intervalo [0, bound).
+ *
+ * Usa multiplicação e deslocamento em vez de `%`, sem divisão.
+ *
+ * @param rng O gerador.
+ * @param bound O limite superior, exclusivo. Deve ser positivo.
+ * @return O número gerado.
+ */
+int range_rng(rng_t *rng, int bound) {
+    return (int) (((next_rng(rng) >> 32) * (uint64_t) bound) >> 32);
+}
+
+/**
+ * @brief Avança o gerador 2^128 passos.
+ *
+ * @param rng O gerador.
+ */
+void jump_rng(rng_t *rng) {
+    static const uint64_t jump[4] = {
+        0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+    };
+    apply_jump(rng, jump);
+}
+
+/**
+ * @brief Avança o gerador 2^192 passos.
+ *
+ * @param rng O gerador.
+ */
+void long_jump_rng(rng_t *rng) {
+    static const uint64_t jump[4] = {
+        0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull, 0x77710069854EE241ull, 0x39109BB02ACBE635ull
+    };
+    apply_jump(rng, jump);
+}
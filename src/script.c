@@ -0,0 +1,205 @@
+/**
+ * @file script.c
+ * @brief Compilação dos scripts de entrada para um formato binário de comandos.
+ *
+ * O mesmo cenário costuma ser executado muitas vezes. Em vez de analisar o texto a
+ * cada execução, o script pode ser compilado uma vez para um arquivo binário com um
+ * registro de tamanho fixo (`script_command_t`) por comando. Os nomes de unidades e
+ * facções são internados em uma tabela ao final do arquivo e os registros guardam
+ * apenas o índice de cada nome.
+ *
+ * `open_source` reconhece o arquivo compilado pelo seu número mágico, e `read_header`
+ * e `read_command` passam a decodificar os registros diretamente do arquivo mapeado
+ * em memória, sem nenhuma análise de texto.
+ */
+
+#include "script.h"
+
+typedef struct name_table_t {
+    name_index_t index;                 // Nome -> posição na tabela + 1
+    char **names;
+    size_t count;
+    size_t capacity;
+} name_table_t;
+
+/**
+ * @brief Devolve o índice de um nome na tabela, inserindo-o se ainda não estiver nela.
+ *
+ * @param table A tabela de nomes do script sendo compilado.
+ * @param name O nome procurado.
+ * @return O índice do nome, ou SCRIPT_NO_NAME se a alocação falhar.
+ */
+static uint32_t intern_name(name_table_t *table, const char *name) {
+    uintptr_t found = (uintptr_t) get_index(&table->index, name);
+    if (found != 0) return (uint32_t) (found - 1);
+
+    if (table->count == table->capacity) {
+        size_t capacity = table->capacity == 0 ? 64 : table->capacity * 2;
+        char **names = (char **) realloc(table->names, capacity * sizeof(char *));
+        if (names == NULL) return SCRIPT_NO_NAME;
+        table->names = names;
+        table->capacity = capacity;
+    }
+
+    char *copy = (char *) calloc(1, SCRIPT_NAME_SIZE);
+    if (copy == NULL) return SCRIPT_NO_NAME;
+    strncpy(copy, name, SCRIPT_NAME_SIZE - 1);
+
+    uint32_t id = (uint32_t) table->count;
+    if (insert_index(&table->index, copy, (void *) (uintptr_t) (id + 1)) != 0) {
+        free(copy);
+        return SCRIPT_NO_NAME;
+    }
+    table->names[table->count++] = copy;
+    return id;
+}
+
+/**
+ * @brief Verifica se um conteúdo começa com o número mágico de um script compilado.
+ *
+ * @param data O início do conteúdo.
+ * @param size O tamanho do conteúdo.
+ * @return Retorna 1 se o conteúdo é um script compilado, ou 0 caso contrário.
+ */
+int is_script(const char *data, size_t size) {
+    return size >= SCRIPT_MAGIC_LEN && memcmp(data, SCRIPT_MAGIC, SCRIPT_MAGIC_LEN) == 0;
+}
+
+/**
+ * @brief Compila um script de texto para o formato binário.
+ *
+ * Cada linha do script vira um `script_command_t`, inclusive as linhas com ações
+ * desconhecidas, para que a execução do arquivo compilado produza o mesmo log que
+ * a do texto.
+ *
+ * @param input O script de texto, aberto em modo de leitura.
+ * @param output O arquivo de saída, aberto em modo de escrita binária. Precisa permitir
+ *               `fseek`, pois o cabeçalho é reescrito ao final.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a entrada não puder ser lida ou a
+ *         saída não puder ser escrita.
+ */
+int compile_script(FILE *input, FILE *output) {
+    source_t source;
+    if (open_stream(&source, input) != 0) return 1;
+
+    script_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SCRIPT_MAGIC, SCRIPT_MAGIC_LEN);
+    header.version = SCRIPT_VERSION;
+
+    int rows, columns, num_factions;
+    if (source.binary || read_header(&source, &rows, &columns, &num_factions) != 0 ||
+        fwrite(&header, sizeof(header), 1, output) != 1) {
+        close_source(&source);
+        return 1;
+    }
+    header.rows = rows;
+    header.columns = columns;
+    header.num_factions = num_factions;
+
+    name_table_t table = {0};
+    init_index(&table.index);
+
+    int status = 0;
+    command_t command;
+    while (status == 0 && read_command(&source, &command) == 0) {
+        script_command_t record;
+        memset(&record, 0, sizeof(record));
+        record.action = (uint8_t) command.action;
+        record.param_count = (uint8_t) command.param_count;
+        for (int i = 0; i < command.param_count; i++) record.params[i] = command.params[i];
+
+        record.part = intern_name(&table, command.part);
+        record.name = command.name[0] != '\0' ? intern_name(&table, command.name) : SCRIPT_NO_NAME;
+        if (record.part == SCRIPT_NO_NAME || (command.name[0] != '\0' && record.name == SCRIPT_NO_NAME) ||
+            fwrite(&record, sizeof(record), 1, output) != 1) {
+            status = 1;
+        }
+        header.command_count++;
+    }
+
+    header.name_count = (uint32_t) table.count;
+    header.names_offset = sizeof(header) + header.command_count * sizeof(script_command_t);
+    for (size_t i = 0; status == 0 && i < table.count; i++) {
+        if (fwrite(table.names[i], SCRIPT_NAME_SIZE, 1, output) != 1) status = 1;
+    }
+    if (status == 0 && (fseek(output, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, output) != 1)) {
+        status = 1;
+    }
+
+    for (size_t i = 0; i < table.count; i++) free(table.names[i]);
+    free(table.names);
+    free_index(&table.index);
+    close_source(&source);
+    return status;
+}
+
+/**
+ * @brief Lê o cabeçalho de um script compilado e valida o tamanho das suas seções.
+ *
+ * @param source Conteúdo aberto com `open_source`, reconhecido como script compilado.
+ * @param rows Onde o número de linhas será armazenado.
+ * @param columns Onde o número de colunas será armazenado.
+ * @param num_factions Onde o número de facções será armazenado.
+ * @return Retorna 0 em caso de sucesso, ou 1 se o cabeçalho for inválido ou o arquivo
+ *         estiver truncado.
+ */
+int read_script_header(source_t *source, int *rows, int *columns, int *num_factions) {
+    size_t available = source->size - source->pos;
+    if (available < sizeof(script_header_t)) return 1;
+
+    script_header_t header;
+    memcpy(&header, source->data + source->pos, sizeof(header));
+    if (header.version != SCRIPT_VERSION) return 1;
+
+    // A tabela de nomes começa logo após o último comando: `read_script_command` para nela
+    uint64_t commands_end = sizeof(header) + header.command_count * sizeof(script_command_t);
+    if (header.command_count > available / sizeof(script_command_t) || commands_end != header.names_offset ||
+        header.names_offset > available ||
+        (uint64_t) header.name_count * SCRIPT_NAME_SIZE > available - header.names_offset) {
+        return 1;
+    }
+
+    source->names = source->data + source->pos + header.names_offset;
+    source->name_count = header.name_count;
+    source->pos += sizeof(header);
+
+    *rows = header.rows;
+    *columns = header.columns;
+    *num_factions = header.num_factions;
+    return 0;
+}
+
+/**
+ * @brief Copia um nome da tabela do script para um buffer de nome.
+ */
+static void copy_script_name(const source_t *source, uint32_t id, char name[COMMAND_NAME_LEN]) {
+    if (id >= source->name_count) {
+        name[0] = '\0';
+        return;
+    }
+    memcpy(name, source->names + (size_t) id * SCRIPT_NAME_SIZE, COMMAND_NAME_LEN - 1);
+    name[COMMAND_NAME_LEN - 1] = '\0';
+}
+
+/**
+ * @brief Lê o próximo comando de um script compilado.
+ *
+ * @param source Conteúdo cujo cabeçalho já foi lido com `read_script_header`.
+ * @param command Registro preenchido com o comando lido.
+ * @return Retorna 0 se um comando foi lido, ou 1 se não houver mais comandos.
+ */
+int read_script_command(source_t *source, command_t *command) {
+    if (source->pos + sizeof(script_command_t) > (size_t) (source->names - source->data)) return 1;
+
+    script_command_t record;
+    memcpy(&record, source->data + source->pos, sizeof(record));
+    source->pos += sizeof(record);
+
+    command->action = record.action <= ACTION_LAST ? (action_e) record.action : ACTION_UNKNOWN;
+    command->param_count = record.param_count <= COMMAND_MAX_PARAMS ? record.param_count : COMMAND_MAX_PARAMS;
+    for (int i = 0; i < command->param_count; i++) command->params[i] = record.params[i];
+    copy_script_name(source, record.part, command->part);
+    copy_script_name(source, record.name, command->name);
+    return 0;
+}
@@ -0,0 +1,777 @@
+/**
+ * @file snapshot.c
+ * @brief Gravação e restauração do estado completo de uma partida.
+ *
+ * Um snapshot guarda, em um único bloco contíguo (veja snapshot.h), tudo o que muda
+ * durante a partida: as listas de facções (com recursos, poder e alianças), de
+ * edifícios e de unidades, o conteúdo de cada célula ocupada do tabuleiro, os handles
+ * do `unit_store_t` e a ordem dos baldes do índice espacial, o histórico do último
+ * ataque, o estado do gerador e o da impressão incremental do tabuleiro. Os ponteiros
+ * são gravados como índices nas listas, e a ordem das listas e dos encadeamentos é
+ * preservada: a partida restaurada continua exatamente como a original continuaria.
+ *
+ * O terreno, o log e os buffers de busca de caminhos não fazem parte do snapshot. O
+ * terreno é gerado de novo a partir da semente (um hash confere que é o mesmo), o log
+ * é o de quem restaura e os buffers de caminhos são recriados na primeira busca.
+ *
+ * `save_game` grava o bloco com uma única escrita, e `load_game` o lê com um único
+ * mapeamento em memória (`open_source`). `fork_game` usa a mesma troca de ponteiros por
+ * posições nas listas para copiar uma partida diretamente para outra, sem passar pelo bloco.
+ */
+
+#include "snapshot.h"
+
+#include <stddef.h>
+
+/**
+ * @brief Associação entre um ponteiro e a sua posição em uma lista, para a busca binária.
+ */
+typedef struct pointer_slot_t {
+    const void *pointer;
+    int32_t index;
+} pointer_slot_t;
+
+/**
+ * @brief Compara duas associações pelo endereço, para `qsort` e `bsearch`.
+ */
+static int compare_slots(const void *a, const void *b) {
+    uintptr_t left = (uintptr_t) ((const pointer_slot_t *) a)->pointer;
+    uintptr_t right = (uintptr_t) ((const pointer_slot_t *) b)->pointer;
+    return (left > right) - (left < right);
+}
+
+/**
+ * @brief Encontra a posição de um ponteiro em uma lista já ordenada por endereço.
+ *
+ * @return A posição do ponteiro, ou SNAPSHOT_NONE se ele for NULL ou não estiver na lista.
+ */
+static int32_t find_slot(const pointer_slot_t *slots, int32_t count, const void *pointer) {
+    if (pointer == NULL || count == 0) return SNAPSHOT_NONE;
+    pointer_slot_t key = {pointer, 0};
+    const pointer_slot_t *found = bsearch(&key, slots, (size_t) count, sizeof(pointer_slot_t), compare_slots);
+    return found != NULL ? found->index : SNAPSHOT_NONE;
+}
+
+/**
+ * @brief Calcula o hash FNV-1a do terreno, para conferir que um snapshot é restaurado sobre o mesmo mapa.
+ */
+static uint32_t hash_terrain(const terrain_t *terrain) {
+    uint32_t hash = 2166136261u;
+    size_t cells = (size_t) terrain->lines * (size_t) terrain->columns;
+    for (size_t i = 0; i < cells; i++) {
+        hash = (hash ^ terrain->cells[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Calcula o tamanho do snapshot descrito por um cabeçalho.
+ */
+static size_t snapshot_size(const snapshot_header_t *header) {
+    return sizeof(snapshot_header_t)
+         + (size_t) header->faction_count * sizeof(snapshot_faction_t)
+         + (size_t) header->alliance_count * sizeof(snapshot_alliance_t)
+         + (size_t) header->building_count * sizeof(snapshot_building_t)
+         + (size_t) header->unit_count * sizeof(snapshot_unit_t)
+         + (size_t) header->cell_count * sizeof(snapshot_cell_t)
+         + ((size_t) header->cell_unit_count + (size_t) header->free_count + (size_t) header->spatial_count
+            + (size_t) header->dirty_count) * sizeof(int32_t)
+         + (size_t) header->shown_count;
+}
+
+/**
+ * @brief Copia bytes para o bloco do snapshot e devolve a posição seguinte.
+ */
+static char *put(char *out, const void *data, size_t size) {
+    if (size > 0) memcpy(out, data, size);
+    return out + size;
+}
+
+/**
+ * @brief Copia bytes do bloco do snapshot e devolve a posição seguinte.
+ */
+static const char *take(const char *in, void *data, size_t size) {
+    if (size > 0) memcpy(data, in, size);
+    return in + size;
+}
+
+/**
+ * @brief Monta a lista, ordenada por endereço, das posições dos itens de uma lista encadeada.
+ *
+ * @param first O primeiro item da lista.
+ * @param count A quantidade de itens.
+ * @param next_offset A posição do campo `next` nos itens.
+ * @param failed Recebe 1 se a alocação falhar.
+ * @return A lista alocada, ou NULL se a lista encadeada estiver vazia ou a alocação falhar.
+ */
+static pointer_slot_t *build_slots(const void *first, int32_t count, size_t next_offset, int *failed) {
+    if (count == 0) return NULL;
+    pointer_slot_t *slots = malloc((size_t) count * sizeof(pointer_slot_t));
+    if (slots == NULL) {
+        *failed = 1;
+        return NULL;
+    }
+    const void *item = first;
+    for (int32_t i = 0; i < count; i++) {
+        slots[i].pointer = item;
+        slots[i].index = i;
+        memcpy(&item, (const char *) item + next_offset, sizeof(void *));
+    }
+    qsort(slots, (size_t) count, sizeof(pointer_slot_t), compare_slots);
+    return slots;
+}
+
+/**
+ * @brief Grava o estado de uma partida em um bloco de memória.
+ *
+ * @param game A partida.
+ * @param data Onde o endereço do bloco alocado será escrito. Deve ser liberado com `free`.
+ * @param size Onde o tamanho do bloco será escrito.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a memória não puder ser alocada.
+ */
+int snapshot_game(const game_t *game, void **data, size_t *size) {
+    const board_t *board = game->board;
+    size_t cells = (size_t) board->lines * (size_t) board->columns;
+
+    snapshot_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN);
+    header.version = SNAPSHOT_VERSION;
+    memcpy(header.rng, game->rng.state, sizeof(header.rng));
+    header.terrain_hash = hash_terrain(game->terrain);
+    header.rows = board->lines;
+    header.columns = board->columns;
+    header.pending_factions = game->pending_factions;
+    header.turns = game->turns;
+    header.history = game->history;
+    memcpy(header.last_part, game->last_part, COMMAND_NAME_LEN);
+
+    // Primeira passada: conta os registros de cada seção
+    for (const faction_t *faction = game->factions; faction != NULL; faction = faction->next) {
+        header.faction_count++;
+        for (const alliance_t *alliance = faction->alliance; alliance != NULL; alliance = alliance->next) {
+            header.alliance_count++;
+        }
+    }
+    for (const building_t *building = game->buildings; building != NULL; building = building->next) header.building_count++;
+    for (const unit_t *unit = game->units; unit != NULL; unit = unit->next) header.unit_count++;
+    for (size_t i = 0; i < cells; i++) {
+        const node_t *cell = &board->cells[i];
+        if (cell->faction == NULL && cell->building == NULL && cell->units == NULL) continue;
+        header.cell_count++;
+        for (const unit_t *unit = cell->units; unit != NULL; unit = unit->cell_next) header.cell_unit_count++;
+    }
+    header.store_count = game->unit_store.count;
+    header.free_count = game->unit_store.free_count;
+    int buckets = game->spatial.bucket_lines * game->spatial.bucket_columns;
+    for (int b = 0; b < buckets; b++) header.spatial_count += game->spatial.buckets[b].count;
+    header.keyframe_interval = board->keyframe_interval;
+    header.frame = board->frame;
+    if (board->shown != NULL) {
+        header.shown_count = (int32_t) (cells + 1);
+        header.dirty_count = board->dirty_count;
+    }
+
+    int failed = 0;
+    pointer_slot_t *faction_slots = build_slots(game->factions, header.faction_count, offsetof(faction_t, next), &failed);
+    pointer_slot_t *building_slots = build_slots(game->buildings, header.building_count, offsetof(building_t, next), &failed);
+    pointer_slot_t *unit_slots = build_slots(game->units, header.unit_count, offsetof(unit_t, next), &failed);
+    char *block = failed ? NULL : malloc(snapshot_size(&header));
+    if (block == NULL) {
+        free(faction_slots);
+        free(building_slots);
+        free(unit_slots);
+        return 1;
+    }
+
+    // Segunda passada: grava as seções na ordem do layout
+    char *out = put(block, &header, sizeof(header));
+    for (const faction_t *faction = game->factions; faction != NULL; faction = faction->next) {
+        snapshot_faction_t record;
+        memset(&record, 0, sizeof(record));
+        memcpy(record.name, faction->name, COMMAND_NAME_LEN);
+        record.indexed = get_index(&game->faction_index, faction->name) == faction;
+        record.id = faction->id;
+        record.resources = faction->resources;
+        record.power = faction->power;
+        for (const alliance_t *alliance = faction->alliance; alliance != NULL; alliance = alliance->next) record.alliance_count++;
+        out = put(out, &record, sizeof(record));
+    }
+    for (const faction_t *faction = game->factions; faction != NULL; faction = faction->next) {
+        for (const alliance_t *alliance = faction->alliance; alliance != NULL; alliance = alliance->next) {
+            snapshot_alliance_t record;
+            memset(&record, 0, sizeof(record));
+            memcpy(record.name, alliance->name, COMMAND_NAME_LEN);
+            out = put(out, &record, sizeof(record));
+        }
+    }
+    for (const building_t *building = game->buildings; building != NULL; building = building->next) {
+        snapshot_building_t record;
+        memset(&record, 0, sizeof(record));
+        record.x = building->x;
+        record.y = building->y;
+        record.type = building->type;
+        memcpy(record.name, building->name, COMMAND_NAME_LEN);
+        out = put(out, &record, sizeof(record));
+    }
+    for (const unit_t *unit = game->units; unit != NULL; unit = unit->next) {
+        snapshot_unit_t record;
+        memset(&record, 0, sizeof(record));
+        record.x = unit->x;
+        record.y = unit->y;
+        record.type = unit->type;
+        record.handle = unit->handle;
+        record.faction_id = unit->handle != UNIT_NO_HANDLE ? game->unit_store.faction_id[unit->handle] : -1;
+        memcpy(record.name, unit->name, COMMAND_NAME_LEN);
+        record.indexed = get_index(&game->unit_index, unit->name) == unit;
+        out = put(out, &record, sizeof(record));
+    }
+    for (size_t i = 0; i < cells; i++) {
+        const node_t *cell = &board->cells[i];
+        if (cell->faction == NULL && cell->building == NULL && cell->units == NULL) continue;
+        snapshot_cell_t record;
+        record.cell = (int32_t) i;
+        record.faction = find_slot(faction_slots, header.faction_count, cell->faction);
+        record.building = find_slot(building_slots, header.building_count, cell->building);
+        record.unit_count = 0;
+        for (const unit_t *unit = cell->units; unit != NULL; unit = unit->cell_next) record.unit_count++;
+        out = put(out, &record, sizeof(record));
+    }
+    for (size_t i = 0; i < cells; i++) {
+        for (const unit_t *unit = board->cells[i].units; unit != NULL; unit = unit->cell_next) {
+            int32_t index = find_slot(unit_slots, header.unit_count, unit);
+            out = put(out, &index, sizeof(index));
+        }
+    }
+    for (int i = 0; i < header.free_count; i++) {
+        int32_t handle = game->unit_store.free_handles[i];
+        out = put(out, &handle, sizeof(handle));
+    }
+    for (int b = 0; b < buckets; b++) {
+        const spatial_bucket_t *bucket = &game->spatial.buckets[b];
+        for (int i = 0; i < bucket->count; i++) {
+            int32_t handle = bucket->handles[i];
+            out = put(out, &handle, sizeof(handle));
+        }
+    }
+    out = put(out, board->shown, (size_t) header.shown_count);
+    for (int i = 0; i < header.dirty_count; i++) {
+        int32_t index = board->dirty[i];
+        out = put(out, &index, sizeof(index));
+    }
+
+    free(faction_slots);
+    free(building_slots);
+    free(unit_slots);
+    *data = block;
+    *size = (size_t) (out - block);
+    return 0;
+}
+
+/**
+ * @brief Recria as facções e as suas alianças, na ordem gravada.
+ *
+ * @return A posição seguinte no bloco, ou NULL se a memória não puder ser alocada.
+ */
+static const char *restore_factions(game_t *game, const snapshot_header_t *header, const char *in, faction_t **faction_at) {
+    const char *records = in;
+    const char *alliances = in + (size_t) header->faction_count * sizeof(snapshot_faction_t);
+    faction_t **tail = &game->factions;
+    int32_t alliance_total = 0;
+
+    for (int32_t i = 0; i < header->faction_count; i++) {
+        snapshot_faction_t record;
+        in = take(in, &record, sizeof(record));
+        record.name[COMMAND_NAME_LEN - 1] = '\0';
+        if (record.alliance_count < 0 || record.alliance_count > header->alliance_count - alliance_total) return NULL;
+        alliance_total += record.alliance_count;
+
+        faction_t *faction = allocate_faction(record.name, record.resources, record.power);
+        if (faction == NULL) return NULL;
+        faction->id = record.id;
+        *tail = faction;
+        tail = &faction->next;
+        faction_at[i] = faction;
+
+        alliance_t **alliance_tail = &faction->alliance;
+        for (int32_t a = 0; a < record.alliance_count; a++) {
+            snapshot_alliance_t name;
+            alliances = take(alliances, &name, sizeof(name));
+            name.name[COMMAND_NAME_LEN - 1] = '\0';
+            alliance_t *alliance = allocate_alliance(name.name);
+            if (alliance == NULL) return NULL;
+            *alliance_tail = alliance;
+            alliance_tail = &alliance->next;
+        }
+    }
+
+    // O índice é refeito na ordem de criação (o inverso da lista), como na partida original
+    for (int32_t i = header->faction_count - 1; i >= 0; i--) {
+        snapshot_faction_t record;
+        take(records + (size_t) i * sizeof(record), &record, sizeof(record));
+        if (record.indexed && insert_index(&game->faction_index, faction_at[i]->name, faction_at[i]) != 0) return NULL;
+    }
+    return alliances;
+}
+
+/**
+ * @brief Recria os edifícios, na ordem gravada.
+ *
+ * @return A posição seguinte no bloco, ou NULL se a memória não puder ser alocada.
+ */
+static const char *restore_buildings(game_t *game, const snapshot_header_t *header, const char *in, building_t **building_at) {
+    building_t **tail = &game->buildings;
+    for (int32_t i = 0; i < header->building_count; i++) {
+        snapshot_building_t record;
+        in = take(in, &record, sizeof(record));
+        record.name[COMMAND_NAME_LEN - 1] = '\0';
+        building_t *building = allocate_building(record.x, record.y, record.name, (building_e) record.type);
+        if (building == NULL) return NULL;
+        *tail = building;
+        tail = &building->next;
+        building_at[i] = building;
+    }
+    return in;
+}
+
+/**
+ * @brief Recria as unidades, na ordem gravada, e o `unit_store_t` com os mesmos handles.
+ *
+ * @return A posição seguinte no bloco, ou NULL se algum handle for inválido ou a memória
+ *         não puder ser alocada.
+ */
+static const char *restore_units(game_t *game, const snapshot_header_t *header, const char *in, unit_t **unit_at) {
+    unit_store_t *store = &game->unit_store;
+    if (reserve_unit_store(store, header->store_count) != 0) return NULL;
+    store->count = header->store_count;
+    for (int32_t h = 0; h < store->count; h++) {
+        store->alive[h] = 0;
+        store->units[h] = NULL;
+    }
+
+    const char *records = in;
+    unit_t **tail = &game->units;
+    for (int32_t i = 0; i < header->unit_count; i++) {
+        snapshot_unit_t record;
+        in = take(in, &record, sizeof(record));
+        record.name[COMMAND_NAME_LEN - 1] = '\0';
+        unit_t *unit = allocate_unit(record.x, record.y, record.name, (unit_e) record.type);
+        if (unit == NULL) return NULL;
+        *tail = unit;
+        tail = &unit->next;
+        unit_at[i] = unit;
+
+        if (record.handle == UNIT_NO_HANDLE) continue;
+        if (record.handle < 0 || record.handle >= store->count || store->alive[record.handle]) return NULL;
+        int handle = record.handle;
+        store->x[handle] = unit->x;
+        store->y[handle] = unit->y;
+        store->type[handle] = (unsigned char) (unit->type >= 0 && unit->type <= EXPLORER ? unit->type : 0);
+        store->faction_id[handle] = record.faction_id;
+        store->alive[handle] = 1;
+        store->units[handle] = unit;
+        store->live++;
+        unit->handle = handle;
+    }
+
+    // Como nas facções, o índice é refeito na ordem de criação
+    for (int32_t i = header->unit_count - 1; i >= 0; i--) {
+        snapshot_unit_t record;
+        take(records + (size_t) i * sizeof(record), &record, sizeof(record));
+        if (record.indexed && insert_index(&game->unit_index, unit_at[i]->name, unit_at[i]) != 0) return NULL;
+    }
+    return in;
+}
+
+/**
+ * @brief Recria o conteúdo das células ocupadas, com as unidades na ordem do encadeamento gravado.
+ *
+ * @return A posição seguinte no bloco, ou NULL se algum índice for inválido, se uma unidade
+ *         estiver em uma célula diferente das suas coordenadas (ou fora de qualquer célula
+ *         estando dentro do tabuleiro) ou se a memória não puder ser alocada.
+ */
+static const char *restore_cells(game_t *game, const snapshot_header_t *header, const char *in,
+                                 faction_t **faction_at, building_t **building_at, unit_t **unit_at) {
+    board_t *board = game->board;
+    int32_t cells = header->rows * header->columns;
+    const char *cell_units = in + (size_t) header->cell_count * sizeof(snapshot_cell_t);
+    int32_t placed_total = 0;
+
+    unsigned char *placed = calloc((size_t) header->unit_count + 1, 1);
+    if (placed == NULL) return NULL;
+
+    for (int32_t i = 0; i < header->cell_count; i++) {
+        snapshot_cell_t record;
+        in = take(in, &record, sizeof(record));
+        if (record.cell < 0 || record.cell >= cells || record.faction < SNAPSHOT_NONE || record.faction >= header->faction_count ||
+            record.building < SNAPSHOT_NONE || record.building >= header->building_count ||
+            record.unit_count < 0 || record.unit_count > header->cell_unit_count - placed_total) {
+            free(placed);
+            return NULL;
+        }
+
+        int line = record.cell / header->columns, col = record.cell % header->columns;
+        insert_node(board, line, col, NULL, record.building != SNAPSHOT_NONE ? building_at[record.building] : NULL,
+                    record.faction != SNAPSHOT_NONE ? faction_at[record.faction] : NULL);
+
+        // `insert_node` encadeia no início da célula: as unidades entram do fim para o começo
+        const char *units = cell_units + (size_t) placed_total * sizeof(int32_t);
+        for (int32_t u = record.unit_count - 1; u >= 0; u--) {
+            int32_t index;
+            take(units + (size_t) u * sizeof(int32_t), &index, sizeof(index));
+            // A unidade deve estar na célula das suas coordenadas, que `move_unit` usa para retirá-la
+            if (index < 0 || index >= header->unit_count || placed[index] || unit_at[index]->x != line || unit_at[index]->y != col) {
+                free(placed);
+                return NULL;
+            }
+            placed[index] = 1;
+            insert_node(board, line, col, unit_at[index], NULL, NULL);
+        }
+        placed_total += record.unit_count;
+    }
+
+    // Uma unidade dentro do tabuleiro sempre está na lista da sua célula
+    for (int32_t i = 0; i < header->unit_count; i++) {
+        const unit_t *unit = unit_at[i];
+        if (!placed[i] && unit->x >= 0 && unit->x < header->rows && unit->y >= 0 && unit->y < header->columns) {
+            free(placed);
+            return NULL;
+        }
+    }
+
+    free(placed);
+    return cell_units + (size_t) header->cell_unit_count * sizeof(int32_t);
+}
+
+/**
+ * @brief Recria os handles livres do `unit_store_t` e os baldes do índice espacial, na ordem gravada.
+ *
+ * @return A posição seguinte no bloco, ou NULL se algum handle for inválido ou a memória
+ *         não puder ser alocada.
+ */
+static const char *restore_handles(game_t *game, const snapshot_header_t *header, const char *in) {
+    unit_store_t *store = &game->unit_store;
+    spatial_t *spatial = &game->spatial;
+
+    if (header->free_count > store->count) return NULL;
+    for (int32_t i = 0; i < header->free_count; i++) {
+        int32_t handle;
+        in = take(in, &handle, sizeof(handle));
+        if (handle < 0 || handle >= store->count || store->alive[handle]) return NULL;
+        store->free_handles[i] = handle;
+    }
+    store->free_count = header->free_count;
+
+    // Os handles entram balde a balde, na ordem gravada, e cada balde os guarda na mesma ordem
+    for (int32_t i = 0; i < header->spatial_count; i++) {
+        int32_t handle;
+        in = take(in, &handle, sizeof(handle));
+        if (handle < 0 || handle >= store->count || !store->alive[handle]) return NULL;
+        if (handle < spatial->handle_capacity && spatial->bucket_of[handle] != SPATIAL_NONE) return NULL;
+        if (insert_spatial(spatial, store, handle) != 0) return NULL;
+    }
+
+    // As unidades fora do tabuleiro não estão em nenhum balde, mas também são registradas
+    for (int h = 0; h < store->count; h++) {
+        if (!store->alive[h]) continue;
+        if (store->x[h] >= 0 && store->x[h] < header->rows && store->y[h] >= 0 && store->y[h] < header->columns) continue;
+        if (insert_spatial(spatial, store, h) != 0) return NULL;
+    }
+    return in;
+}
+
+/**
+ * @brief Recria o estado da impressão incremental do tabuleiro.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se algum índice for inválido ou a memória
+ *         não puder ser alocada.
+ */
+static int restore_frames(game_t *game, const snapshot_header_t *header, const char *in) {
+    board_t *board = game->board;
+    if (header->shown_count > 0) {
+        if (set_board_keyframes(board, 1) != 0) return 1;
+        in = take(in, board->shown, (size_t) header->shown_count);
+        for (int32_t i = 0; i < header->dirty_count; i++) {
+            int32_t index;
+            in = take(in, &index, sizeof(index));
+            if (index < 0 || index >= header->shown_count) return 1;
+            board->dirty[i] = index;
+        }
+        board->dirty_count = header->dirty_count;
+    }
+    board->keyframe_interval = header->keyframe_interval;
+    board->frame = header->frame;
+    return 0;
+}
+
+/**
+ * @brief Restaura uma partida a partir de um bloco gravado por `snapshot_game`.
+ *
+ * A partida restaurada continua exatamente como a original continuaria: as mesmas
+ * listas, na mesma ordem, os mesmos handles, o mesmo gerador e o mesmo histórico.
+ *
+ * @param game A partida a ser iniciada. Deve ser encerrada depois com `end_game`.
+ * @param data O bloco do snapshot.
+ * @param size O tamanho do bloco.
+ * @param terrain O mapa de terrenos da partida original (o mesmo gerado com a mesma semente).
+ * @param log O log onde a partida restaurada será registrada.
+ * @return Retorna 0 em caso de sucesso, ou 1 se o bloco não for um snapshot válido, não
+ *         corresponder ao terreno ou a memória não puder ser alocada. Em caso de falha,
+ *         a partida não precisa ser encerrada.
+ */
+int restore_game(game_t *game, const void *data, size_t size, const terrain_t *terrain, log_t *log) {
+    snapshot_header_t header;
+    if (size < sizeof(header)) return 1;
+    const char *in = take((const char *) data, &header, sizeof(header));
+
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN) != 0 || header.version != SNAPSHOT_VERSION) return 1;
+    if (header.rows != terrain->lines || header.columns != terrain->columns || header.terrain_hash != hash_terrain(terrain)) return 1;
+    if (header.faction_count < 0 || header.alliance_count < 0 || header.building_count < 0 || header.unit_count < 0 ||
+        header.cell_count < 0 || header.cell_unit_count < 0 || header.store_count < 0 || header.free_count < 0 ||
+        header.spatial_count < 0 || header.dirty_count < 0 || header.shown_count < 0 || header.dirty_count > header.shown_count) return 1;
+    if (header.shown_count != 0 && header.shown_count != header.rows * header.columns + 1) return 1;
+    if (snapshot_size(&header) != size) return 1;
+
+    rng_t rng;
+    memcpy(rng.state, header.rng, sizeof(rng.state));
+    if (start_game(game, header.rows, header.columns, header.pending_factions, &rng, terrain, log) != 0) return 1;
+    game->turns = header.turns;
+    game->history = header.history;
+    memcpy(game->last_part, header.last_part, COMMAND_NAME_LEN);
+    game->last_part[COMMAND_NAME_LEN - 1] = '\0';
+
+    faction_t **faction_at = malloc(((size_t) header.faction_count + 1) * sizeof(faction_t *));
+    building_t **building_at = malloc(((size_t) header.building_count + 1) * sizeof(building_t *));
+    unit_t **unit_at = malloc(((size_t) header.unit_count + 1) * sizeof(unit_t *));
+
+    // Cada objeto é ligado à partida assim que criado, e `end_game` libera tudo em caso de falha
+    int status = faction_at == NULL || building_at == NULL || unit_at == NULL;
+    if (status == 0) in = restore_factions(game, &header, in, faction_at);
+    if (status == 0 && in != NULL) in = restore_buildings(game, &header, in, building_at);
+    if (status == 0 && in != NULL) in = restore_units(game, &header, in, unit_at);
+    if (status == 0 && in != NULL) in = restore_cells(game, &header, in, faction_at, building_at, unit_at);
+    if (status == 0 && in != NULL) in = restore_handles(game, &header, in);
+    if (status == 0) status = in == NULL || restore_frames(game, &header, in) != 0;
+
+    free(faction_at);
+    free(building_at);
+    free(unit_at);
+    if (status != 0) {
+        end_game(game);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Copia as facções, os edifícios e as unidades de uma partida e refaz os ponteiros da cópia.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a memória não puder ser alocada.
+ */
+static int fork_objects(game_t *child, const game_t *parent, int32_t faction_count, int32_t building_count, int32_t unit_count,
+                        faction_t **faction_at, building_t **building_at, unit_t **unit_at) {
+    int failed = 0;
+    pointer_slot_t *faction_slots = build_slots(parent->factions, faction_count, offsetof(faction_t, next), &failed);
+    pointer_slot_t *building_slots = build_slots(parent->buildings, building_count, offsetof(building_t, next), &failed);
+    pointer_slot_t *unit_slots = build_slots(parent->units, unit_count, offsetof(unit_t, next), &failed);
+
+    // As listas são copiadas na mesma ordem; cada objeto é ligado à cópia assim que criado
+    int32_t i = 0;
+    faction_t **faction_tail = &child->factions;
+    for (const faction_t *faction = parent->factions; faction != NULL && !failed; faction = faction->next, i++) {
+        faction_t *copy = allocate_faction((char *) faction->name, faction->resources, faction->power);
+        if (copy == NULL) {
+            failed = 1;
+            break;
+        }
+        copy->id = faction->id;
+        *faction_tail = copy;
+        faction_tail = &copy->next;
+        faction_at[i] = copy;
+
+        alliance_t **alliance_tail = &copy->alliance;
+        for (const alliance_t *alliance = faction->alliance; alliance != NULL; alliance = alliance->next) {
+            alliance_t *ally = allocate_alliance((char *) alliance->name);
+            if (ally == NULL) {
+                failed = 1;
+                break;
+            }
+            *alliance_tail = ally;
+            alliance_tail = &ally->next;
+        }
+    }
+
+    i = 0;
+    building_t **building_tail = &child->buildings;
+    for (const building_t *building = parent->buildings; building != NULL && !failed; building = building->next, i++) {
+        building_t *copy = allocate_building(building->x, building->y, (char *) building->name, building->type);
+        if (copy == NULL) {
+            failed = 1;
+            break;
+        }
+        *building_tail = copy;
+        building_tail = &copy->next;
+        building_at[i] = copy;
+    }
+
+    i = 0;
+    unit_t **unit_tail = &child->units;
+    for (const unit_t *unit = parent->units; unit != NULL && !failed; unit = unit->next, i++) {
+        unit_t *copy = allocate_unit(unit->x, unit->y, (char *) unit->name, unit->type);
+        if (copy == NULL) {
+            failed = 1;
+            break;
+        }
+        copy->handle = unit->handle;
+        if (copy->handle != UNIT_NO_HANDLE) child->unit_store.units[copy->handle] = copy;
+        *unit_tail = copy;
+        unit_tail = &copy->next;
+        unit_at[i] = copy;
+    }
+
+    if (!failed) {
+        // Encadeamento das unidades nas células e conteúdo das células ocupadas
+        i = 0;
+        for (const unit_t *unit = parent->units; unit != NULL; unit = unit->next, i++) {
+            int32_t prev = find_slot(unit_slots, unit_count, unit->cell_prev);
+            int32_t next = find_slot(unit_slots, unit_count, unit->cell_next);
+            unit_at[i]->cell_prev = prev != SNAPSHOT_NONE ? unit_at[prev] : NULL;
+            unit_at[i]->cell_next = next != SNAPSHOT_NONE ? unit_at[next] : NULL;
+        }
+
+        size_t cells = (size_t) child->board->lines * child->board->columns;
+        for (size_t c = 0; c < cells; c++) {
+            node_t *cell = &child->board->cells[c];
+            if (cell->faction == NULL && cell->building == NULL && cell->units == NULL) continue;
+            int32_t faction = find_slot(faction_slots, faction_count, cell->faction);
+            int32_t building = find_slot(building_slots, building_count, cell->building);
+            int32_t unit = find_slot(unit_slots, unit_count, cell->units);
+            cell->faction = faction != SNAPSHOT_NONE ? faction_at[faction] : NULL;
+            cell->building = building != SNAPSHOT_NONE ? building_at[building] : NULL;
+            cell->units = unit != SNAPSHOT_NONE ? unit_at[unit] : NULL;
+        }
+
+        // Os índices apontam para as cópias dos mesmos objetos que os índices da partida original
+        i = 0;
+        for (const faction_t *faction = parent->factions; faction != NULL && !failed; faction = faction->next, i++) {
+            if (get_index(&parent->faction_index, faction->name) != faction) continue;
+            failed = insert_index(&child->faction_index, faction_at[i]->name, faction_at[i]) != 0;
+        }
+        i = 0;
+        for (const unit_t *unit = parent->units; unit != NULL && !failed; unit = unit->next, i++) {
+            if (get_index(&parent->unit_index, unit->name) != unit) continue;
+            failed = insert_index(&child->unit_index, unit_at[i]->name, unit_at[i]) != 0;
+        }
+    }
+
+    free(faction_slots);
+    free(building_slots);
+    free(unit_slots);
+    return failed;
+}
+
+/**
+ * @brief Cria uma cópia independente de uma partida, para explorar jogadas alternativas.
+ *
+ * A cópia continua exatamente como a original continuaria (as mesmas listas, handles,
+ * gerador e histórico), mas cada uma evolui sem afetar a outra. O terreno é
+ * compartilhado, e não copiado: a original não deve liberá-lo enquanto houver cópias.
+ * As células do tabuleiro, os arrays do `unit_store_t` e os baldes do índice espacial
+ * são copiados em blocos; as facções, os edifícios e as unidades são copiados um a um
+ * (dos pools da thread que chama) e os ponteiros entre eles são refeitos pela posição
+ * nas listas. Os buffers de busca de caminhos começam vazios na cópia.
+ *
+ * @param child A partida a ser iniciada como cópia. Deve ser encerrada com `end_game`.
+ * @param parent A partida copiada. Não é alterada.
+ * @param log O log onde a cópia será registrada.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a memória não puder ser alocada. Em caso
+ *         de falha, a cópia não precisa ser encerrada.
+ */
+int fork_game(game_t *child, const game_t *parent, log_t *log) {
+    child->board = copy_board(parent->board);
+    if (child->board == NULL) return 1;
+
+    child->terrain = parent->terrain;
+    child->factions = NULL;
+    child->buildings = NULL;
+    child->units = NULL;
+    init_index(&child->faction_index);
+    init_index(&child->unit_index);
+    init_unit_store(&child->unit_store);
+    init_pathfinder(&child->pathfinder, parent->board->lines, parent->board->columns);
+    child->rng = parent->rng;
+    child->history = parent->history;
+    child->log = log;
+    child->pending_factions = parent->pending_factions;
+    child->turns = parent->turns;
+    memcpy(child->last_part, parent->last_part, COMMAND_NAME_LEN);
+
+    int32_t faction_count = 0, building_count = 0, unit_count = 0;
+    for (const faction_t *faction = parent->factions; faction != NULL; faction = faction->next) faction_count++;
+    for (const building_t *building = parent->buildings; building != NULL; building = building->next) building_count++;
+    for (const unit_t *unit = parent->units; unit != NULL; unit = unit->next) unit_count++;
+
+    faction_t **faction_at = malloc(((size_t) faction_count + 1) * sizeof(faction_t *));
+    building_t **building_at = malloc(((size_t) building_count + 1) * sizeof(building_t *));
+    unit_t **unit_at = malloc(((size_t) unit_count + 1) * sizeof(unit_t *));
+
+    int status = copy_spatial(&child->spatial, &parent->spatial);
+    if (status == 0) status = faction_at == NULL || building_at == NULL || unit_at == NULL;
+    if (status == 0) status = copy_unit_store(&child->unit_store, &parent->unit_store);
+    if (status == 0) {
+        status = fork_objects(child, parent, faction_count, building_count, unit_count, faction_at, building_at, unit_at);
+    }
+
+    free(faction_at);
+    free(building_at);
+    free(unit_at);
+    if (status != 0) {
+        end_game(child);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Grava o estado de uma partida em um arquivo, com uma única escrita.
+ *
+ * @param game A partida.
+ * @param path O arquivo de destino.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a memória não puder ser alocada ou o
+ *         arquivo não puder ser escrito.
+ */
+int save_game(const game_t *game, const char *path) {
+    void *data;
+    size_t size;
+    if (snapshot_game(game, &data, &size) != 0) return 1;
+
+    FILE *file = fopen(path, "wb");
+    int status = file == NULL || fwrite(data, 1, size, file) != size;
+    if (file != NULL && fclose(file) != 0) status = 1;
+    free(data);
+    return status;
+}
+
+/**
+ * @brief Restaura uma partida gravada com `save_game`, mapeando o arquivo em memória.
+ *
+ * @param game A partida a ser iniciada. Deve ser encerrada depois com `end_game`.
+ * @param path O arquivo do snapshot.
+ * @param terrain O mapa de terrenos da partida original (o mesmo gerado com a mesma semente).
+ * @param log O log onde a partida restaurada será registrada.
+ * @return Retorna 0 em caso de sucesso, ou 1 se o arquivo não puder ser lido ou não for
+ *         um snapshot válido para este terreno (veja `restore_game`).
+ */
+int load_game(game_t *game, const char *path, const terrain_t *terrain, log_t *log) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return 1;
+
+    source_t source;
+    int status = open_source(&source, file);
+    if (status == 0) {
+        status = restore_game(game, source.data, source.size, terrain, log);
+        close_source(&source);
+    }
+    fclose(file);
+    return status;
+}
@@ -0,0 +1,346 @@
+/**
+ * @file spatial.c
+ * @brief Índice espacial das unidades em uma grade uniforme de baldes.
+ *
+ * O tabuleiro é dividido em baldes de SPATIAL_BUCKET_SIZE x SPATIAL_BUCKET_SIZE células.
+ * Cada balde guarda, em um array, os handles das unidades que estão nele, e cada
+ * handle sabe em que balde e em que posição do array está: inserir, mover e remover
+ * uma unidade custam O(1). As consultas por retângulo e por raio só visitam os baldes
+ * que cruzam a área consultada, de modo que o custo é proporcional ao número de
+ * unidades encontradas (mais os baldes visitados), e não ao total de unidades.
+ *
+ * O índice é mantido pelos manipuladores junto com o `unit_store_t`, de onde vêm as
+ * posições exatas de cada unidade.
+ */
+
+#include "spatial.h"
+
+/**
+ * @brief Calcula o balde de uma célula.
+ *
+ * @return O índice do balde, ou SPATIAL_NONE se a célula estiver fora do tabuleiro.
+ */
+static int bucket_index(const spatial_t *spatial, int line, int col) {
+    if (line < 0 || line >= spatial->lines || col < 0 || col >= spatial->columns) return SPATIAL_NONE;
+    return (line >> SPATIAL_BUCKET_SHIFT) * spatial->bucket_columns + (col >> SPATIAL_BUCKET_SHIFT);
+}
+
+/**
+ * @brief Garante espaço para o handle nos arrays indexados por handle.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar.
+ */
+static int reserve_handle(spatial_t *spatial, int handle) {
+    if (handle < spatial->handle_capacity) return 0;
+
+    int capacity = spatial->handle_capacity == 0 ? 64 : spatial->handle_capacity;
+    while (capacity <= handle) capacity *= 2;
+
+    int *bucket_of = realloc(spatial->bucket_of, capacity * sizeof(int));
+    if (bucket_of == NULL) return 1;
+    spatial->bucket_of = bucket_of;
+    int *slot_of = realloc(spatial->slot_of, capacity * sizeof(int));
+    if (slot_of == NULL) return 1;
+    spatial->slot_of = slot_of;
+
+    for (int i = spatial->handle_capacity; i < capacity; i++) spatial->bucket_of[i] = SPATIAL_NONE;
+    spatial->handle_capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Acrescenta um handle a um balde.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar.
+ */
+static int add_to_bucket(spatial_t *spatial, int bucket, int handle) {
+    spatial->bucket_of[handle] = bucket;
+    if (bucket == SPATIAL_NONE) return 0;
+
+    spatial_bucket_t *b = &spatial->buckets[bucket];
+    if (b->count == b->capacity) {
+        int capacity = b->capacity == 0 ? 4 : b->capacity * 2;
+        int *handles = realloc(b->handles, capacity * sizeof(int));
+        if (handles == NULL) {
+            spatial->bucket_of[handle] = SPATIAL_NONE;
+            return 1;
+        }
+        b->handles = handles;
+        b->capacity = capacity;
+    }
+    spatial->slot_of[handle] = b->count;
+    b->handles[b->count++] = handle;
+    return 0;
+}
+
+/**
+ * @brief Tira um handle do seu balde, trocando-o pelo último handle do balde.
+ */
+static void take_from_bucket(spatial_t *spatial, int handle) {
+    int bucket = spatial->bucket_of[handle];
+    if (bucket == SPATIAL_NONE) return;
+
+    spatial_bucket_t *b = &spatial->buckets[bucket];
+    int slot = spatial->slot_of[handle];
+    int last = b->handles[--b->count];
+    b->handles[slot] = last;
+    spatial->slot_of[last] = slot;
+    spatial->bucket_of[handle] = SPATIAL_NONE;
+}
+
+/**
+ * @brief Acrescenta um handle ao resultado de uma consulta, se ainda couber.
+ */
+static inline void emit_handle(int *handles, int capacity, int *found, int handle) {
+    if (*found < capacity) handles[*found] = handle;
+    (*found)++;
+}
+
+/**
+ * @brief Inicializa um índice vazio para um tabuleiro.
+ *
+ * @param spatial O índice a ser inicializado.
+ * @param lines O número de linhas do tabuleiro.
+ * @param columns O número de colunas do tabuleiro.
+ * @return Retorna 0 em caso de sucesso, ou 1 se as dimensões forem inválidas ou a alocação falhar.
+ */
+int init_spatial(spatial_t *spatial, int lines, int columns) {
+    memset(spatial, 0, sizeof(spatial_t));
+    if (lines < 0 || columns < 0) return 1;
+
+    spatial->lines = lines;
+    spatial->columns = columns;
+    spatial->bucket_lines = (lines + SPATIAL_BUCKET_SIZE - 1) >> SPATIAL_BUCKET_SHIFT;
+    spatial->bucket_columns = (columns + SPATIAL_BUCKET_SIZE - 1) >> SPATIAL_BUCKET_SHIFT;
+
+    size_t count = (size_t) spatial->bucket_lines * spatial->bucket_columns;
+    spatial->buckets = calloc(count > 0 ? count : 1, sizeof(spatial_bucket_t));
+    return spatial->buckets == NULL;
+}
+
+/**
+ * @brief Insere no índice uma unidade recém-registrada no armazenamento.
+ *
+ * @param spatial O índice.
+ * @param store O armazenamento, de onde vem a posição da unidade.
+ * @param handle O handle da unidade. Se for UNIT_NO_HANDLE, nada acontece.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar.
+ */
+int insert_spatial(spatial_t *spatial, const unit_store_t *store, int handle) {
+    if (handle == UNIT_NO_HANDLE) return 0;
+    if (reserve_handle(spatial, handle) != 0) return 1;
+    return add_to_bucket(spatial, bucket_index(spatial, store->x[handle], store->y[handle]), handle);
+}
+
+/**
+ * @brief Atualiza o balde de uma unidade que mudou de posição.
+ *
+ * @param spatial O índice.
+ * @param handle O handle da unidade. Se for UNIT_NO_HANDLE, nada acontece.
+ * @param line A nova linha da unidade.
+ * @param col A nova coluna da unidade.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar.
+ */
+int move_spatial(spatial_t *spatial, int handle, int line, int col) {
+    if (handle == UNIT_NO_HANDLE || handle >= spatial->handle_capacity) return 0;
+
+    int bucket = bucket_index(spatial, line, col);
+    if (bucket == spatial->bucket_of[handle]) return 0;
+    take_from_bucket(spatial, handle);
+    return add_to_bucket(spatial, bucket, handle);
+}
+
+/**
+ * @brief Remove uma unidade do índice.
+ *
+ * @param spatial O índice.
+ * @param handle O handle da unidade. Se for UNIT_NO_HANDLE, nada acontece.
+ */
+void remove_spatial(spatial_t *spatial, int handle) {
+    if (handle == UNIT_NO_HANDLE || handle >= spatial->handle_capacity) return;
+    take_from_bucket(spatial, handle);
+}
+
+/**
+ * @brief Lista as unidades dentro de um retângulo do tabuleiro, com os limites inclusos.
+ *
+ * @param spatial O índice.
+ * @param store O armazenamento, de onde vêm as posições exatas.
+ * @param line0 A primeira linha do retângulo.
+ * @param col0 A primeira coluna do retângulo.
+ * @param line1 A última linha do retângulo.
+ * @param col1 A última coluna do retângulo.
+ * @param handles Array onde os handles serão escritos, em nenhuma ordem particular.
+ * @param capacity Quantos handles cabem em `handles`.
+ * @return O número de unidades no retângulo, que pode ser maior que `capacity`.
+ */
+int query_rect_spatial(const spatial_t *spatial, const unit_store_t *store, int line0, int col0, int line1, int col1,
+                       int *handles, int capacity) {
+    if (line0 < 0) line0 = 0;
+    if (col0 < 0) col0 = 0;
+    if (line1 >= spatial->lines) line1 = spatial->lines - 1;
+    if (col1 >= spatial->columns) col1 = spatial->columns - 1;
+    if (line0 > line1 || col0 > col1) return 0;
+
+    int found = 0;
+    for (int bl = line0 >> SPATIAL_BUCKET_SHIFT; bl <= line1 >> SPATIAL_BUCKET_SHIFT; bl++) {
+        for (int bc = col0 >> SPATIAL_BUCKET_SHIFT; bc <= col1 >> SPATIAL_BUCKET_SHIFT; bc++) {
+            const spatial_bucket_t *b = &spatial->buckets[bl * spatial->bucket_columns + bc];
+            for (int i = 0; i < b->count; i++) {
+                int h = b->handles[i];
+                if (store->x[h] >= line0 && store->x[h] <= line1 && store->y[h] >= col0 && store->y[h] <= col1) {
+                    emit_handle(handles, capacity, &found, h);
+                }
+            }
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Lista as unidades a uma distância (euclidiana) de no máximo `radius` células de uma posição.
+ *
+ * @param spatial O índice.
+ * @param store O armazenamento, de onde vêm as posições exatas.
+ * @param line A linha do centro.
+ * @param col A coluna do centro.
+ * @param radius O raio, em células.
+ * @param handles Array onde os handles serão escritos, em nenhuma ordem particular.
+ * @param capacity Quantos handles cabem em `handles`.
+ * @return O número de unidades no raio, que pode ser maior que `capacity`.
+ */
+int query_radius_spatial(const spatial_t *spatial, const unit_store_t *store, int line, int col, int radius,
+                         int *handles, int capacity) {
+    if (radius < 0) return 0;
+
+    int line0 = line - radius < 0 ? 0 : line - radius;
+    int col0 = col - radius < 0 ? 0 : col - radius;
+    int line1 = line + radius >= spatial->lines ? spatial->lines - 1 : line + radius;
+    int col1 = col + radius >= spatial->columns ? spatial->columns - 1 : col + radius;
+    if (line0 > line1 || col0 > col1) return 0;
+
+    long long limit = (long long) radius * radius;
+    int found = 0;
+    for (int bl = line0 >> SPATIAL_BUCKET_SHIFT; bl <= line1 >> SPATIAL_BUCKET_SHIFT; bl++) {
+        for (int bc = col0 >> SPATIAL_BUCKET_SHIFT; bc <= col1 >> SPATIAL_BUCKET_SHIFT; bc++) {
+            const spatial_bucket_t *b = &spatial->buckets[bl * spatial->bucket_columns + bc];
+            for (int i = 0; i < b->count; i++) {
+                int h = b->handles[i];
+                long long dl = store->x[h] - line, dc = store->y[h] - col;
+                if (dl * dl + dc * dc <= limit) emit_handle(handles, capacity, &found, h);
+            }
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Encontra a unidade inimiga mais próxima de uma unidade.
+ *
+ * Os baldes são visitados em anéis cada vez maiores em volta do balde da unidade, e a
+ * busca termina assim que nenhum balde do próximo anel puder conter uma unidade mais
+ * próxima que a melhor encontrada.
+ *
+ * @param spatial O índice.
+ * @param store O armazenamento, de onde vêm as posições e as facções.
+ * @param handle O handle da unidade de referência.
+ * @param friendly Marca, por id de facção, as facções que não são inimigas da unidade
+ *                 (a sua e as aliadas). Unidades sem facção (id -1) ou com um id fora
+ *                 de `friendly` são sempre inimigas.
+ * @param friendly_count A quantidade de ids em `friendly`.
+ * @return O handle da unidade inimiga mais próxima (em caso de empate, o menor handle),
+ *         ou UNIT_NO_HANDLE se não houver nenhuma no tabuleiro.
+ */
+int nearest_enemy_spatial(const spatial_t *spatial, const unit_store_t *store, int handle,
+                          const unsigned char *friendly, int friendly_count) {
+    if (handle == UNIT_NO_HANDLE || spatial->bucket_lines == 0 || spatial->bucket_columns == 0) return UNIT_NO_HANDLE;
+
+    int line = store->x[handle], col = store->y[handle];
+    int inside = bucket_index(spatial, line, col) != SPATIAL_NONE;
+
+    // Fora do tabuleiro, a busca parte do balde mais próximo e não pode ser interrompida cedo
+    int center_line = (line < 0 ? 0 : line >= spatial->lines ? spatial->lines - 1 : line) >> SPATIAL_BUCKET_SHIFT;
+    int center_col = (col < 0 ? 0 : col >= spatial->columns ? spatial->columns - 1 : col) >> SPATIAL_BUCKET_SHIFT;
+    int max_ring = spatial->bucket_lines > spatial->bucket_columns ? spatial->bucket_lines : spatial->bucket_columns;
+
+    int best = UNIT_NO_HANDLE;
+    long long best_distance = 0;
+    for (int ring = 0; ring <= max_ring; ring++) {
+        // Toda célula de um balde do anel `ring` está a pelo menos (ring - 1) * SIZE + 1 células em alguma direção
+        if (inside && best != UNIT_NO_HANDLE && ring > 0) {
+            long long gap = (long long) (ring - 1) * SPATIAL_BUCKET_SIZE + 1;
+            if (gap * gap > best_distance) break;
+        }
+
+        for (int bl = center_line - ring; bl <= center_line + ring; bl++) {
+            if (bl < 0 || bl >= spatial->bucket_lines) continue;
+            // Nas linhas internas do anel, só as duas colunas das bordas
+            int step = (bl == center_line - ring || bl == center_line + ring || ring == 0) ? 1 : 2 * ring;
+            for (int bc = center_col - ring; bc <= center_col + ring; bc += step) {
+                if (bc < 0 || bc >= spatial->bucket_columns) continue;
+
+                const spatial_bucket_t *b = &spatial->buckets[bl * spatial->bucket_columns + bc];
+                for (int i = 0; i < b->count; i++) {
+                    int h = b->handles[i];
+                    int faction_id = store->faction_id[h];
+                    if (h == handle || (faction_id >= 0 && faction_id < friendly_count && friendly[faction_id])) continue;
+                    long long dl = store->x[h] - line, dc = store->y[h] - col;
+                    long long distance = dl * dl + dc * dc;
+                    if (best == UNIT_NO_HANDLE || distance < best_distance || (distance == best_distance && h < best)) {
+                        best = h;
+                        best_distance = distance;
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Copia um índice, com os handles de cada balde na mesma ordem.
+ *
+ * @param copy O índice de destino, ainda não inicializado.
+ * @param spatial O índice copiado.
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar (e `copy` fica vazio).
+ */
+int copy_spatial(spatial_t *copy, const spatial_t *spatial) {
+    if (init_spatial(copy, spatial->lines, spatial->columns) != 0) return 1;
+    if (spatial->handle_capacity > 0) {
+        if (reserve_handle(copy, spatial->handle_capacity - 1) != 0) {
+            free_spatial(copy);
+            return 1;
+        }
+        memcpy(copy->bucket_of, spatial->bucket_of, spatial->handle_capacity * sizeof(int));
+        memcpy(copy->slot_of, spatial->slot_of, spatial->handle_capacity * sizeof(int));
+    }
+
+    int count = spatial->bucket_lines * spatial->bucket_columns;
+    for (int i = 0; i < count; i++) {
+        const spatial_bucket_t *bucket = &spatial->buckets[i];
+        if (bucket->count == 0) continue;
+        copy->buckets[i].handles = malloc(bucket->count * sizeof(int));
+        if (copy->buckets[i].handles == NULL) {
+            free_spatial(copy);
+            return 1;
+        }
+        memcpy(copy->buckets[i].handles, bucket->handles, bucket->count * sizeof(int));
+        copy->buckets[i].count = bucket->count;
+        copy->buckets[i].capacity = bucket->count;
+    }
+    return 0;
+}
+
+/**
+ * @brief Libera os baldes e os arrays do índice.
+ *
+ * @param spatial O índice a ser liberado.
+ */
+void free_spatial(spatial_t *spatial) {
+    int count = spatial->bucket_lines * spatial->bucket_columns;
+    for (int i = 0; i < count && spatial->buckets != NULL; i++) free(spatial->buckets[i].handles);
+    free(spatial->buckets);
+    free(spatial->bucket_of);
+    free(spatial->slot_of);
+    memset(spatial, 0, sizeof(spatial_t));
+}
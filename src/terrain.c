@@ -0,0 +1,135 @@
+/**
+ * @file terrain.c
+ * @brief Mapa de terrenos do tabuleiro, usado pela coleta de recursos.
+ *
+ * O terreno de cada célula é um `node_e` (planície, floresta ou montanha) guardado em
+ * um byte, em uma grade alocada no heap com as mesmas dimensões e a mesma ordem do
+ * tabuleiro. A grade é gerada por um gerador pseudoaleatório com semente explícita:
+ * cada linha tem a sua própria sequência, derivada da semente e do número da linha,
+ * de modo que faixas de linhas podem ser geradas em paralelo e o resultado não depende
+ * do número de threads.
+ */
+
+#include "terrain.h"
+
+typedef struct terrain_stripe_t {
+    terrain_t *terrain;
+    uint64_t seed;
+    int first;                          // Primeira linha da faixa
+    int last;                           // Uma depois da última linha da faixa
+} terrain_stripe_t;
+
+/**
+ * @brief Avança um estado splitmix64 e devolve o próximo número da sequência.
+ */
+static uint64_t next_splitmix(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Gera as linhas de uma faixa do mapa.
+ *
+ * Cada célula sorteia um valor de 0 a 9: de 0 a 5 é planície, de 6 a 8 é floresta
+ * e 9 é montanha.
+ */
+static void *generate_stripe(void *arg) {
+    terrain_stripe_t *stripe = (terrain_stripe_t *) arg;
+    terrain_t *terrain = stripe->terrain;
+
+    for (int line = stripe->first; line < stripe->last; line++) {
+        uint64_t state = stripe->seed ^ ((uint64_t) line * 0xD1B54A32D192ED03ull);
+        unsigned char *row = terrain->cells + (size_t) line * terrain->columns;
+        for (int col = 0; col < terrain->columns; col++) {
+            uint32_t value = (uint32_t) (((next_splitmix(&state) >> 32) * 10) >> 32); // 0 a 9, sem divisão
+            row[col] = value < 6 ? PLANICE : value < 9 ? FLORESTA : MONTANHA;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Cria um mapa de terrenos, todo de planície.
+ *
+ * @param lines O número de linhas do mapa.
+ * @param columns O número de colunas do mapa.
+ * @return Um ponteiro para o mapa, ou NULL se as dimensões forem inválidas ou a alocação falhar.
+ */
+terrain_t *create_terrain(int lines, int columns) {
+    if (lines < 0 || columns < 0) return NULL;
+
+    terrain_t *terrain = (terrain_t *) malloc(sizeof(terrain_t));
+    if (terrain == NULL) return NULL;
+
+    terrain->lines = lines;
+    terrain->columns = columns;
+    terrain->cells = (unsigned char *) calloc((size_t) lines * (size_t) columns + TERRAIN_PADDING, 1);
+    if (terrain->cells == NULL) {
+        free(terrain);
+        return NULL;
+    }
+    return terrain;
+}
+
+/**
+ * @brief Sorteia o terreno de todas as células do mapa.
+ *
+ * As linhas são divididas em faixas contíguas, uma por thread. O mapa gerado depende
+ * apenas da semente, e não do número de threads.
+ *
+ * @param terrain O mapa a ser gerado.
+ * @param seed A semente do gerador.
+ * @param threads Quantas threads usar. Com 1 ou menos (ou se a criação de uma thread
+ *                falhar), as faixas são geradas na thread atual.
+ */
+void generate_terrain(terrain_t *terrain, uint64_t seed, int threads) {
+    if (threads > TERRAIN_MAX_THREADS) threads = TERRAIN_MAX_THREADS;
+    if (threads > terrain->lines) threads = terrain->lines;
+    if (threads < 1) threads = 1;
+
+    terrain_stripe_t stripes[threads];
+    pthread_t workers[threads];
+    int started[threads];
+
+    for (int i = 0; i < threads; i++) {
+        stripes[i].terrain = terrain;
+        stripes[i].seed = seed;
+        stripes[i].first = (int) ((long long) terrain->lines * i / threads);
+        stripes[i].last = (int) ((long long) terrain->lines * (i + 1) / threads);
+        started[i] = i > 0 && pthread_create(&workers[i], NULL, generate_stripe, &stripes[i]) == 0;
+    }
+
+    // A primeira faixa (e qualquer faixa cuja thread não pôde ser criada) é gerada aqui
+    for (int i = 0; i < threads; i++) {
+        if (!started[i]) generate_stripe(&stripes[i]);
+    }
+    for (int i = 1; i < threads; i++) {
+        if (started[i]) pthread_join(workers[i], NULL);
+    }
+}
+
+/**
+ * @brief Obtém o terreno de uma célula.
+ *
+ * @param terrain O mapa de terrenos.
+ * @param line A linha da célula.
+ * @param col A coluna da célula.
+ * @return O `node_e` da célula, ou TERRAIN_NONE se a posição estiver fora do mapa.
+ */
+int get_terrain(const terrain_t *terrain, int line, int col) {
+    if (line < 0 || line >= terrain->lines || col < 0 || col >= terrain->columns) return TERRAIN_NONE;
+    return terrain->cells[(size_t) line * terrain->columns + col];
+}
+
+/**
+ * @brief Libera um mapa de terrenos.
+ *
+ * @param terrain O mapa a ser liberado. Se for NULL, nada acontece.
+ */
+void free_terrain(terrain_t *terrain) {
+    if (terrain == NULL) return;
+    free(terrain->cells);
+    free(terrain);
+}
@@ -12,6 +12,11 @@
  * Operações básicas de alocação, liberação e manipulação são providas por funções
  * como `allocate_unit`, `insert_unit`, `remove_unit`, `get_unit` e `free_units`.
  *
+ * Ao lado da lista, `unit_store_t` guarda posição, tipo, facção e estado de cada
+ * unidade em arrays paralelos, indexados por um handle inteiro estável. Operações
+ * sobre todas as unidades percorrem esses arrays em sequência, sem seguir ponteiros
+ * nem trazer os nomes para o cache.
+ *
  */
 
 #include "unit.h"
@@ -24,9 +29,10 @@
 /**
  * @brief Aloca e inicializa um novo nó do tipo unit_t com os valores especificados.
  *
- * Esta função aloca dinamicamente um novo nó do tipo `unit_t` e inicializa seus campos
+ * Esta função aloca um novo nó do tipo `unit_t` do pool de unidades e inicializa seus campos
  * com os valores fornecidos para as coordenadas `x` e `y`, o nome `name` e o tipo `type`.
- * O campo `next` é inicializado como NULL.
+ * Os campos `next`, `cell_prev` e `cell_next` são inicializados como NULL, e a unidade
+ * ainda não possui handle no `unit_store_t`.
  *
  * @param x A coordenada x do novo nó.
  * @param y A coordenada y do novo nó.
@@ -38,13 +44,16 @@
  */
 unit_t *allocate_unit(int x, int y, char name[15], unit_e type){
     unit_t *new_unit = NULL;
-    new_unit = (unit_t *) malloc(sizeof(unit_t));
+    new_unit = pool_alloc(POOL_UNIT, sizeof(unit_t));
     if(new_unit == NULL) return NULL;
     strcpy(new_unit->name, name);
     new_unit->x = x;
     new_unit->y = y;
     new_unit->type = type;
     new_unit->next = NULL;
+    new_unit->cell_prev = NULL;
+    new_unit->cell_next = NULL;
+    new_unit->handle = UNIT_NO_HANDLE;
     return new_unit;
 }
 
@@ -89,8 +98,8 @@ void insert_unit(unit_t **units, int x, int y, char name[15], unit_e type){
  * @return Um ponteiro para o nó da lista encadeada com o nome especificado, ou NULL se
  *         nenhum nó com esse nome for encontrado.
  *
- * @note A função assume que a lista foi alocada dinamicamente e que cada nó foi
- *       corretamente alocado com malloc ou uma função similar.
+ * @note A função assume que cada nó da lista foi alocado com `allocate_unit`,
+ *       a partir do pool de unidades.
  * @note A função não realiza verificações adicionais sobre a validade dos ponteiros ou da string.
  */
 unit_t *get_unit(unit_t **units, char name[15]){
@@ -109,15 +118,15 @@ unit_t *get_unit(unit_t **units, char name[15]){
  *
  * Esta função percorre uma lista encadeada de unidades, procurando por um nó com as
  * coordenadas `x` e `y` especificadas. Se encontrar um nó com essas coordenadas, ele
- * é removido da lista e a memória alocada para esse nó é liberada.
+ * é removido da lista e devolvido ao pool de unidades.
  *
  * @param units Um ponteiro duplo para o primeiro nó da lista encadeada de unidades.
  *              Este ponteiro será atualizado se o nó removido for o primeiro da lista.
  * @param x A coordenada x do nó a ser removido.
  * @param y A coordenada y do nó a ser removido.
  *
- * @note A função assume que a lista foi alocada dinamicamente e que cada nó foi
- *       corretamente alocado com malloc ou uma função similar.
+ * @note A função assume que cada nó da lista foi alocado com `allocate_unit`,
+ *       a partir do pool de unidades.
  * @note A função não realiza verificações adicionais sobre a validade dos ponteiros.
  * @note Se não houver um nó com as coordenadas especificadas, a lista permanecerá inalterada.
  */
@@ -132,7 +141,7 @@ void remove_unit(unit_t **units, int x, int y){
             else{
                 previous->next = current->next;
             }
-            free(current);
+            pool_free(POOL_UNIT, current);
             return;
         }
         previous = current;
@@ -140,23 +149,228 @@ void remove_unit(unit_t **units, int x, int y){
     }
 }
 
+/**
+ * @brief Remove um nó específico da lista encadeada de unidades.
+ *
+ * Diferente de `remove_unit`, que remove o primeiro nó encontrado nas coordenadas
+ * informadas, esta função remove exatamente o nó `unit`, mesmo que outras unidades
+ * ocupem a mesma posição. O nó é devolvido ao pool de unidades.
+ *
+ * @param units Um ponteiro duplo para o primeiro nó da lista encadeada de unidades.
+ *              Este ponteiro será atualizado se o nó removido for o primeiro da lista.
+ * @param unit O nó a ser removido. Se não pertencer à lista, a lista permanecerá inalterada.
+ */
+void delete_unit(unit_t **units, unit_t *unit){
+    unit_t **current = units;
+    while(*current != NULL){
+        if(*current == unit){
+            *current = unit->next;
+            pool_free(POOL_UNIT, unit);
+            return;
+        }
+        current = &(*current)->next;
+    }
+}
+
 /**
  * @brief Libera a memória alocada para uma lista encadeada de estruturas do tipo unit_t.
  *
- * Esta função percorre uma lista encadeada de unidades, liberando a memória alocada para
- * cada nó da lista. A lista é representada por um ponteiro duplo para o primeiro nó.
+ * Esta função percorre uma lista encadeada de unidades, devolvendo cada nó ao pool de
+ * unidades. A lista é representada por um ponteiro duplo para o primeiro nó. Para encerrar
+ * uma partida inteira de uma vez, veja `release_pools`.
  *
  * @param units Um ponteiro duplo para o primeiro nó da lista encadeada de unidades.
  *              Após a execução da função, o ponteiro será atualizado para NULL.
  *
- * @note A função assume que a lista foi alocada dinamicamente e que cada nó foi
- *       corretamente alocado com malloc ou uma função similar.
+ * @note A função assume que cada nó da lista foi alocado com `allocate_unit`,
+ *       a partir do pool de unidades.
  * @note A função não realiza verificações adicionais sobre a validade dos ponteiros.
  */
 void free_units(unit_t **units){
     while(*units != NULL){
         unit_t *temp = *units;
         *units = (*units)->next;
-        free(temp);
+        pool_free(POOL_UNIT, temp);
+    }
+}
+
+/**
+ * @brief Inicializa um armazenamento de unidades vazio.
+ *
+ * @param store O armazenamento a ser inicializado. Os arrays só são alocados na primeira inserção.
+ */
+void init_unit_store(unit_store_t *store){
+    memset(store, 0, sizeof(unit_store_t));
+}
+
+/**
+ * @brief Dobra a capacidade de todos os arrays do armazenamento.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar.
+ */
+static int grow_unit_store(unit_store_t *store){
+    int capacity = store->capacity == 0 ? 64 : store->capacity * 2;
+
+    int *x = realloc(store->x, capacity * sizeof(int));
+    if(x == NULL) return 1;
+    store->x = x;
+    int *y = realloc(store->y, capacity * sizeof(int));
+    if(y == NULL) return 1;
+    store->y = y;
+    unsigned char *type = realloc(store->type, capacity);
+    if(type == NULL) return 1;
+    store->type = type;
+    int *faction_id = realloc(store->faction_id, capacity * sizeof(int));
+    if(faction_id == NULL) return 1;
+    store->faction_id = faction_id;
+    unsigned char *alive = realloc(store->alive, capacity);
+    if(alive == NULL) return 1;
+    store->alive = alive;
+    unit_t **units = realloc(store->units, capacity * sizeof(unit_t *));
+    if(units == NULL) return 1;
+    store->units = units;
+    int *free_handles = realloc(store->free_handles, capacity * sizeof(int));
+    if(free_handles == NULL) return 1;
+    store->free_handles = free_handles;
+
+    store->capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Garante espaço para `count` handles no armazenamento, sem registrar unidades.
+ *
+ * Usada para reconstruir um armazenamento com os mesmos handles (veja snapshot.c).
+ *
+ * @param store O armazenamento de unidades.
+ * @param count A quantidade de handles necessária.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar.
+ */
+int reserve_unit_store(unit_store_t *store, int count){
+    while(store->capacity < count){
+        if(grow_unit_store(store) != 0) return 1;
     }
+    return 0;
+}
+
+/**
+ * @brief Copia os arrays de um armazenamento, com os mesmos handles.
+ *
+ * As unidades não são copiadas: `copy->units` aponta para as mesmas unidades de `store`
+ * e deve ser atualizado por quem copiou as unidades (veja `fork_game`).
+ *
+ * @param copy O armazenamento de destino, vazio.
+ * @param store O armazenamento copiado.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se a alocação falhar.
+ */
+int copy_unit_store(unit_store_t *copy, const unit_store_t *store){
+    if(reserve_unit_store(copy, store->count) != 0) return 1;
+    if(store->count > 0){
+        memcpy(copy->x, store->x, store->count * sizeof(int));
+        memcpy(copy->y, store->y, store->count * sizeof(int));
+        memcpy(copy->type, store->type, store->count);
+        memcpy(copy->faction_id, store->faction_id, store->count * sizeof(int));
+        memcpy(copy->alive, store->alive, store->count);
+        memcpy(copy->units, store->units, store->count * sizeof(unit_t *));
+        memcpy(copy->free_handles, store->free_handles, store->free_count * sizeof(int));
+    }
+    copy->count = store->count;
+    copy->live = store->live;
+    copy->free_count = store->free_count;
+    return 0;
+}
+
+/**
+ * @brief Registra uma unidade no armazenamento e atribui a ela um handle.
+ *
+ * @param store O armazenamento de unidades.
+ * @param unit A unidade registrada. Seu campo `handle` é preenchido.
+ * @param faction_id O identificador da facção da unidade, ou -1 se ela não tiver facção.
+ *
+ * @return O handle da unidade, ou UNIT_NO_HANDLE se a alocação falhar.
+ */
+int insert_unit_store(unit_store_t *store, unit_t *unit, int faction_id){
+    int handle;
+    if(store->free_count > 0){
+        handle = store->free_handles[--store->free_count];
+    }
+    else{
+        if(store->count == store->capacity && grow_unit_store(store) != 0) return UNIT_NO_HANDLE;
+        handle = store->count++;
+    }
+
+    store->x[handle] = unit->x;
+    store->y[handle] = unit->y;
+    store->type[handle] = (unsigned char) (unit->type >= 0 && unit->type <= EXPLORER ? unit->type : 0);
+    store->faction_id[handle] = faction_id;
+    store->alive[handle] = 1;
+    store->units[handle] = unit;
+    store->live++;
+    unit->handle = handle;
+    return handle;
+}
+
+/**
+ * @brief Atualiza a posição de uma unidade no armazenamento.
+ *
+ * @param store O armazenamento de unidades.
+ * @param handle O handle da unidade. Se for UNIT_NO_HANDLE, nada acontece.
+ * @param x A nova coordenada x.
+ * @param y A nova coordenada y.
+ */
+void move_unit_store(unit_store_t *store, int handle, int x, int y){
+    if(handle == UNIT_NO_HANDLE) return;
+    store->x[handle] = x;
+    store->y[handle] = y;
+}
+
+/**
+ * @brief Remove uma unidade do armazenamento, liberando o seu handle para reaproveitamento.
+ *
+ * @param store O armazenamento de unidades.
+ * @param handle O handle da unidade. Se for UNIT_NO_HANDLE ou já estiver livre, nada acontece.
+ */
+void remove_unit_store(unit_store_t *store, int handle){
+    if(handle == UNIT_NO_HANDLE || !store->alive[handle]) return;
+    store->units[handle]->handle = UNIT_NO_HANDLE;
+    store->alive[handle] = 0;
+    store->units[handle] = NULL;
+    store->free_handles[store->free_count++] = handle;
+    store->live--;
+}
+
+/**
+ * @brief Lista os handles das unidades vivas, em uma varredura linear dos arrays.
+ *
+ * @param store O armazenamento de unidades.
+ * @param faction_id Lista apenas as unidades desta facção, ou todas se for -1.
+ * @param handles Array onde os handles serão escritos. Deve ter espaço para `store->count` handles.
+ *
+ * @return A quantidade de handles escritos.
+ */
+int list_units_store(const unit_store_t *store, int faction_id, int *handles){
+    int found = 0;
+    for(int i = 0; i < store->count; i++){
+        handles[found] = i;
+        found += store->alive[i] && (faction_id == -1 || store->faction_id[i] == faction_id);
+    }
+    return found;
+}
+
+/**
+ * @brief Libera os arrays do armazenamento. As unidades em si não são liberadas.
+ *
+ * @param store O armazenamento a ser liberado. Fica vazio e pode ser reutilizado.
+ */
+void free_unit_store(unit_store_t *store){
+    free(store->x);
+    free(store->y);
+    free(store->type);
+    free(store->faction_id);
+    free(store->alive);
+    free(store->units);
+    free(store->free_handles);
+    init_unit_store(store);
 }
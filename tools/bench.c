@@ -0,0 +1,283 @@
+/**
+ * @file bench.c
+ * @brief Mede o desempenho do motor do jogo com cenários sintéticos.
+ *
+ * A ferramenta gera um cenário com o tamanho de tabuleiro, o número de facções, de
+ * unidades e de comandos pedidos e com uma mistura de ações escolhida por perfil
+ * (movimento, coleta, combate ou construção), lê o cenário com o mesmo analisador do
+ * jogo e o executa com a biblioteca (veja engine.h). Ao final, imprime a vazão da
+ * leitura e da execução, o tempo médio de cada tipo de ação, os bytes escritos no log
+ * e o pico de memória do processo.
+ *
+ * Uso: bench [-l linhas] [-c colunas] [-f facções] [-u unidades] [-n comandos]
+ *            [-a perfil] [-s semente] [-o log] [-x categorias] [-g cenario]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "engine.h"
+
+#define BENCH_MAX_FACTIONS 26           // Uma letra por facção
+
+typedef enum bench_action_e {
+    BENCH_MOVE,
+    BENCH_COLLECT,
+    BENCH_COMBAT,
+    BENCH_BUILD,
+    BENCH_ATTACK,
+    BENCH_WALK,
+    BENCH_ACTION_COUNT
+} bench_action_e;
+
+/**
+ * @brief Perfil de cenário: peso de cada ação na mistura de comandos gerados.
+ */
+typedef struct bench_profile_t {
+    const char *name;
+    int weights[BENCH_ACTION_COUNT];    // Indexado por `bench_action_e`
+} bench_profile_t;
+
+static const bench_profile_t bench_profiles[] = {
+    {"misto", {35, 30, 15, 10, 5, 5}},
+    {"movimento", {80, 10, 5, 5, 0, 0}},
+    {"coleta", {10, 80, 5, 5, 0, 0}},
+    {"combate", {10, 5, 80, 5, 0, 0}},
+    {"construcao", {10, 5, 5, 80, 0, 0}},
+};
+
+typedef struct bench_options_t {
+    int lines;
+    int columns;
+    int factions;
+    int units;
+    long commands;
+    const bench_profile_t *profile;
+    uint64_t seed;
+    const char *log_path;
+    unsigned int log_categories;
+    const char *scenario_path;          // Se não for NULL, o cenário gerado é guardado neste arquivo
+} bench_options_t;
+
+/**
+ * @brief Lê o relógio monotônico em nanossegundos.
+ */
+static long long now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/**
+ * @brief Escreve o nome de uma unidade: a letra da facção seguida do número da unidade.
+ */
+static void unit_name(char name[COMMAND_NAME_LEN], int unit, int factions) {
+    snprintf(name, COMMAND_NAME_LEN, "%c%d", 'A' + unit % factions, unit / factions + 1);
+}
+
+/**
+ * @brief Gera o cenário no arquivo `out`, no formato de entrada do jogo.
+ */
+static void generate_scenario(FILE *out, const bench_options_t *options) {
+    rng_t rng;
+    seed_rng(&rng, options->seed);
+    int lines = options->lines, columns = options->columns, factions = options->factions;
+    char name[COMMAND_NAME_LEN], enemy[COMMAND_NAME_LEN];
+
+    fprintf(out, "%d %d\n%d\n", lines, columns, factions);
+    for (int f = 0; f < factions; f++) {
+        fprintf(out, "F%c pos %d %d\n", 'A' + f, range_rng(&rng, lines), range_rng(&rng, columns));
+    }
+    for (int u = 0; u < options->units; u++) {
+        unit_name(name, u, factions);
+        fprintf(out, "%s pos %d %d %d\n", name, 1 + range_rng(&rng, 2), range_rng(&rng, lines), range_rng(&rng, columns));
+    }
+
+    int total_weight = 0;
+    for (int a = 0; a < BENCH_ACTION_COUNT; a++) total_weight += options->profile->weights[a];
+
+    for (long i = 0; i < options->commands; i++) {
+        int pick = range_rng(&rng, total_weight), action = 0;
+        while (pick >= options->profile->weights[action]) pick -= options->profile->weights[action++];
+
+        int unit = range_rng(&rng, options->units);
+        int type = 1 + range_rng(&rng, 2);
+        unit_name(name, unit, factions);
+        switch ((bench_action_e) action) {
+            case BENCH_MOVE:
+                fprintf(out, "%s move %d %d %d\n", name, type, range_rng(&rng, lines), range_rng(&rng, columns));
+                break;
+            case BENCH_COLLECT:
+                fprintf(out, "%s coleta %d 10\n", name, type);
+                break;
+            case BENCH_COMBAT: {
+                // Um inimigo de outra facção, quando houver mais de uma
+                int target = factions > 1 ? unit + 1 + range_rng(&rng, factions - 1) : range_rng(&rng, options->units);
+                // Depois da última unidade, volta para a primeira da mesma facção do alvo
+                if (target >= options->units) target %= factions;
+                // Com menos unidades que facções, cada unidade é de uma facção diferente
+                if (target >= options->units) target = (unit + 1) % options->units;
+                unit_name(enemy, target, factions);
+                fprintf(out, "%s combate %d %s %d\n", name, type, enemy, type);
+                break;
+            }
+            case BENCH_BUILD:
+                fprintf(out, "F%c constroi %d 1 %d %d\n", 'A' + unit % factions, 1 + range_rng(&rng, 3),
+                        range_rng(&rng, lines), range_rng(&rng, columns));
+                break;
+            case BENCH_ATTACK:
+                fprintf(out, "F%c ataca F%c\n", 'A' + unit % factions, 'A' + range_rng(&rng, factions));
+                break;
+            case BENCH_WALK:
+                fprintf(out, "%s caminha %d %d %d 8\n", name, type, range_rng(&rng, lines), range_rng(&rng, columns));
+                break;
+            case BENCH_ACTION_COUNT:
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Lê as opções da linha de comando.
+ *
+ * @return Retorna 0 em caso de sucesso, ou 1 se alguma opção for inválida.
+ */
+static int parse_options(int argc, char *argv[], bench_options_t *options) {
+    options->lines = 40;
+    options->columns = 40;
+    options->factions = 4;
+    options->units = 400;
+    options->commands = 20000;
+    options->profile = &bench_profiles[0];
+    options->seed = RNG_DEFAULT_SEED;
+    options->log_path = "/dev/null";
+    options->log_categories = LOG_ALL;
+    options->scenario_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "l:c:f:u:n:a:s:o:x:g:")) != -1) {
+        switch (opt) {
+            case 'l': options->lines = atoi(optarg); break;
+            case 'c': options->columns = atoi(optarg); break;
+            case 'f': options->factions = atoi(optarg); break;
+            case 'u': options->units = atoi(optarg); break;
+            case 'n': options->commands = atol(optarg); break;
+            case 's': options->seed = strtoull(optarg, NULL, 0); break;
+            case 'o': options->log_path = optarg; break;
+            case 'g': options->scenario_path = optarg; break;
+            case 'a': {
+                size_t count = sizeof(bench_profiles) / sizeof(bench_profiles[0]);
+                options->profile = NULL;
+                for (size_t i = 0; i < count; i++) {
+                    if (strcmp(bench_profiles[i].name, optarg) == 0) options->profile = &bench_profiles[i];
+                }
+                if (options->profile == NULL) {
+                    printf("Perfis válidos: misto, movimento, coleta, combate, construcao.\n");
+                    return 1;
+                }
+                break;
+            }
+            case 'x': {
+                unsigned int disabled;
+                if (parse_log_categories(optarg, &disabled) != 0) {
+                    printf("Categorias de log válidas: eventos, tabuleiro, turnos, resultado.\n");
+                    return 1;
+                }
+                options->log_categories &= ~disabled;
+                break;
+            }
+            default:
+                return 1;
+        }
+    }
+
+    if (options->lines < 1 || options->columns < 1 || options->units < 1 || options->commands <= 0 ||
+        options->factions < 1 || options->factions > BENCH_MAX_FACTIONS) {
+        printf("Dimensões, unidades e comandos devem ser positivos, com 1 a %d facções.\n", BENCH_MAX_FACTIONS);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    bench_options_t options;
+    if (parse_options(argc, argv, &options) != 0) {
+        printf("Uso: %s [-l linhas] [-c colunas] [-f facções] [-u unidades] [-n comandos] "
+               "[-a perfil] [-s semente] [-o log] [-x categorias] [-g cenario]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *scenario = options.scenario_path != NULL ? fopen(options.scenario_path, "w+") : tmpfile();
+    if (scenario == NULL) {
+        printf("Falha ao criar o arquivo do cenário.\n");
+        return 1;
+    }
+    generate_scenario(scenario, &options);
+    fflush(scenario);
+    rewind(scenario);
+
+    // Leitura: o cenário inteiro é convertido em `command_t` pelo analisador do jogo
+    long long start = now_ns();
+    source_t source;
+    int rows, columns, num_factions;
+    command_t *commands;
+    size_t count;
+    if (open_source(&source, scenario) != 0 || read_header(&source, &rows, &columns, &num_factions) != 0 ||
+        read_all_commands(&source, &commands, &count) != 0) {
+        printf("Falha ao ler o cenário gerado.\n");
+        return 1;
+    }
+    long long parse_ns = now_ns() - start;
+    close_source(&source);
+    fclose(scenario);
+
+    game_config_t config = {rows, columns, num_factions, options.seed, 1, options.log_path, options.log_categories, 0};
+    game_t *game = game_create(&config);
+    if (game == NULL) {
+        printf("Falha ao criar a partida.\n");
+        free(commands);
+        return 1;
+    }
+
+    // Execução: cada comando é cronometrado e somado ao tempo da sua ação
+    long long action_ns[ACTION_LAST + 1] = {0};
+    long action_calls[ACTION_LAST + 1] = {0};
+    start = now_ns();
+    for (size_t i = 0; i < count; i++) {
+        long long before = now_ns();
+        game_apply_command(game, &commands[i]);
+        action_ns[commands[i].action] += now_ns() - before;
+        action_calls[commands[i].action]++;
+    }
+    finish_game(game);
+    flush_log(game->log);
+    long long run_ns = now_ns() - start;
+    size_t log_bytes = game->log->written;
+    game_destroy(game);
+    release_pools();
+    free(commands);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("=== Benchmark ===\n");
+    printf("cenário: %dx%d, %d facções, %d unidades, %zu comandos, perfil %s\n",
+           rows, columns, num_factions, options.units, count, options.profile->name);
+    printf("leitura: %.2f ms (%.0f comandos/s)\n", parse_ns / 1e6, count / (parse_ns / 1e9));
+    printf("execução: %.2f ms (%.0f comandos/s)\n", run_ns / 1e6, count / (run_ns / 1e9));
+    printf("%-12s %10s %14s %12s\n", "ação", "chamadas", "ns/chamada", "% do tempo");
+    for (int a = 0; a <= ACTION_LAST; a++) {
+        if (action_calls[a] == 0) continue;
+        printf("%-12s %10ld %14.0f %11.1f%%\n", get_action_name((action_e) a), action_calls[a],
+               (double) action_ns[a] / action_calls[a], 100.0 * action_ns[a] / run_ns);
+    }
+    printf("log: %zu bytes\n", log_bytes);
+    printf("pico de memória (RSS): %ld KiB\n", usage.ru_maxrss);
+    return 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file replay.c
+ * @brief Reconstrói o tabuleiro de um quadro qualquer a partir de um log incremental.
+ *
+ * Quando o jogo é executado com `-k N`, o log registra o tabuleiro completo apenas nos
+ * quadros-chave (`=== Quadro X (completo) ===`) e, nos demais quadros, somente as células
+ * alteradas (`=== Quadro X (diferença) ===`, seguido de linhas `(linha, coluna) [XXX]`).
+ * Esta ferramenta lê o log, parte do último quadro-chave anterior ao quadro pedido,
+ * aplica as diferenças seguintes e imprime o tabuleiro completo daquele quadro.
+ *
+ * Uso: replay <log> <quadro>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Tabuleiro reconstruído, com o símbolo de 3 caracteres de cada célula.
+ */
+typedef struct replay_t {
+    int lines;
+    int columns;
+    char *glyphs;   // lines * columns símbolos de 3 caracteres, linha a linha
+} replay_t;
+
+/**
+ * @brief Lê um tabuleiro completo do log, logo após o cabeçalho de um quadro-chave.
+ *
+ * @param log Arquivo de log posicionado na borda superior do tabuleiro.
+ * @param replay Tabuleiro reconstruído, redimensionado conforme as linhas lidas.
+ * @param line Buffer de linha reutilizado entre as leituras.
+ * @param size Tamanho do buffer de linha.
+ *
+ * @return Retorna 0 se o tabuleiro foi lido com sucesso, ou 1 em caso de falha.
+ */
+static int read_keyframe(FILE *log, replay_t *replay, char **line, size_t *size) {
+    ssize_t length = getline(line, size, log);
+    if (length < 2 || (*line)[0] != '_') return 1;
+
+    int columns = (int) (length - 2) / 6;
+    int lines = 0;
+    long position = ftell(log);
+
+    // Conta as linhas do tabuleiro (cada linha de células é seguida de uma separadora)
+    while ((length = getline(line, size, log)) > 0 && (*line)[0] == '|') {
+        lines++;
+    }
+    lines /= 2;
+    fseek(log, position, SEEK_SET);
+
+    if (lines != replay->lines || columns != replay->columns) {
+        char *glyphs = (char *) realloc(replay->glyphs, (size_t) lines * columns * 3 + 1);
+        if (glyphs == NULL) return 1;
+        replay->glyphs = glyphs;
+        replay->lines = lines;
+        replay->columns = columns;
+    }
+
+    for (int i = 0; i < lines; i++) {
+        if (getline(line, size, log) < (ssize_t) columns * 6) return 1;
+        for (int j = 0; j < columns; j++) {
+            memcpy(&replay->glyphs[((size_t) i * columns + j) * 3], *line + j * 6 + 3, 3);
+        }
+        if (getline(line, size, log) < 0) return 1; // Linha separadora
+    }
+    return 0;
+}
+
+/**
+ * @brief Imprime o tabuleiro reconstruído no mesmo formato usado pelo jogo.
+ *
+ * @param out Arquivo de saída.
+ * @param replay Tabuleiro reconstruído.
+ */
+static void print_replay(FILE *out, const replay_t *replay) {
+    for (int j = 0; j < replay->columns * 6 + 1; j++) fputc('_', out);
+    fputc('\n', out);
+    for (int i = 0; i < replay->lines; i++) {
+        for (int j = 0; j < replay->columns; j++) {
+            fprintf(out, "|  %.3s", &replay->glyphs[((size_t) i * replay->columns + j) * 3]);
+        }
+        fprintf(out, "|\n");
+        for (int j = 0; j < replay->columns; j++) fprintf(out, "|_____");
+        fprintf(out, "|\n");
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        printf("Uso: %s <log> <quadro>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *log = fopen(argv[1], "r");
+    if (log == NULL) {
+        printf("Falha ao abrir o log %s.\n", argv[1]);
+        return 1;
+    }
+    int target = atoi(argv[2]);
+
+    replay_t replay = {0, 0, NULL};
+    char *line = NULL;
+    size_t size = 0;
+    int frame = -1;        // Último quadro aplicado
+    int in_diff = 0;       // Se as linhas seguintes pertencem a um quadro de diferença
+    int has_keyframe = 0;
+
+    while (getline(&line, &size, log) > 0) {
+        int number, row, col, matched = 0;
+        char glyph[4];
+
+        // `%n` confirma que o cabeçalho inteiro corresponde, e não apenas o número do quadro
+        if (sscanf(line, "=== Quadro %d (completo) ===%n", &number, &matched) == 1 && matched > 0) {
+            if (number > target) break;
+            if (read_keyframe(log, &replay, &line, &size) != 0) {
+                printf("Quadro-chave %d malformado.\n", number);
+                break;
+            }
+            frame = number;
+            has_keyframe = 1;
+            in_diff = 0;
+        } else if (sscanf(line, "=== Quadro %d (diferença) ===%n", &number, &matched) == 1 && matched > 0) {
+            if (number > target) break;
+            frame = number;
+            in_diff = has_keyframe;
+        } else if (in_diff && sscanf(line, "(%d, %d) [%3c]", &row, &col, glyph) == 3) {
+            if (row >= 0 && row < replay.lines && col >= 0 && col < replay.columns) {
+                memcpy(&replay.glyphs[((size_t) row * replay.columns + col) * 3], glyph, 3);
+            }
+        } else {
+            in_diff = 0;
+        }
+    }
+
+    int status = 0;
+    if (!has_keyframe || frame != target) {
+        printf("Quadro %d não encontrado no log.\n", target);
+        status = 1;
+    } else {
+        print_replay(stdout, &replay);
+    }
+
+    free(line);
+    free(replay.glyphs);
+    fclose(log);
+    return status;
+}